@@ -0,0 +1,147 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+export module columns;
+import vfs;
+
+namespace columns
+{
+/**
+ * Bounds a folder has to satisfy, unset bounds accept every folder
+ */
+export struct Filter
+{
+    uint16_t min_depth{0};
+    uint16_t max_depth{std::numeric_limits<uint16_t>::max()};
+    uint32_t min_entries{0};
+    int64_t min_mtime{std::numeric_limits<int64_t>::min()};
+    std::optional<uint32_t> owner; // Folders without a known owner never match
+};
+
+/**
+ * Per folder metadata stored as one array per attribute, indexed by candidate id.
+ * Filters scan one column at a time with branchless comparisons so that the
+ * loops vectorize and only touch the attributes they filter on.
+ */
+export class Columns
+{
+  public:
+    /**
+     * Appends a folder, its other attributes are set once its directory is read.
+     * Symlinked folders are never read and keep no entries, no mtime and vfs::NO_OWNER.
+     * @param depth number of path components below root
+     */
+    void add(size_t depth)
+    {
+        m_depth.push_back(static_cast<uint16_t>(std::min<size_t>(depth, std::numeric_limits<uint16_t>::max())));
+        m_entries.push_back(0);
+        m_mtime.push_back(0);
+        m_owner.push_back(vfs::NO_OWNER);
+    }
+
+    /**
+     * @param id index of folder
+     * @param entries number of entries in the folder
+     * @param mtime last modification in seconds since epoch
+     * @param owner user id, vfs::NO_OWNER if unknown
+     */
+    void set(uint32_t id, uint32_t entries, int64_t mtime, uint32_t owner)
+    {
+        m_entries[id] = entries;
+        m_mtime[id] = mtime;
+        m_owner[id] = owner;
+    }
+
+    /**
+     * Reorders all columns, the folder at order[id] becomes id
+     * @param order permutation of ids
+     */
+    void permute(std::span<const uint32_t> order)
+    {
+        gather(m_depth, order);
+        gather(m_entries, order);
+        gather(m_mtime, order);
+        gather(m_owner, order);
+    }
+
+    /**
+     * @return size_t number of folders
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return m_depth.size();
+    }
+
+    /**
+     * Computes which folders pass filter
+     * @param filter bounds to check
+     * @param mask set to 1 for every passing id and 0 otherwise
+     */
+    void scan(const Filter& filter, std::vector<uint8_t>& mask) const
+    {
+        mask.assign(size(), 1);
+        if (filter.min_depth != 0 || filter.max_depth != std::numeric_limits<uint16_t>::max())
+        {
+            for (size_t id = 0; id < mask.size(); id++)
+            {
+                mask[id] = static_cast<uint8_t>(mask[id] & static_cast<uint8_t>(m_depth[id] >= filter.min_depth) & static_cast<uint8_t>(m_depth[id] <= filter.max_depth));
+            }
+        }
+        if (filter.min_entries != 0)
+        {
+            for (size_t id = 0; id < mask.size(); id++)
+            {
+                mask[id] = static_cast<uint8_t>(mask[id] & static_cast<uint8_t>(m_entries[id] >= filter.min_entries));
+            }
+        }
+        if (filter.min_mtime != std::numeric_limits<int64_t>::min())
+        {
+            for (size_t id = 0; id < mask.size(); id++)
+            {
+                mask[id] = static_cast<uint8_t>(mask[id] & static_cast<uint8_t>(m_mtime[id] >= filter.min_mtime));
+            }
+        }
+        if (filter.owner)
+        {
+            for (size_t id = 0; id < mask.size(); id++)
+            {
+                mask[id] = static_cast<uint8_t>(mask[id] & static_cast<uint8_t>(m_owner[id] == *filter.owner) & static_cast<uint8_t>(m_owner[id] != vfs::NO_OWNER));
+            }
+        }
+    }
+
+    /**
+     * @return size_t bytes used by all columns
+     */
+    [[nodiscard]] size_t bytes() const
+    {
+        return m_depth.capacity() * sizeof(uint16_t) + m_entries.capacity() * sizeof(uint32_t) + m_mtime.capacity() * sizeof(int64_t) + m_owner.capacity() * sizeof(uint32_t);
+    }
+
+  private:
+    template <typename T>
+    static void gather(std::vector<T>& column, std::span<const uint32_t> order)
+    {
+        std::vector<T> sorted;
+        sorted.reserve(order.size());
+        for (auto id : order)
+        {
+            sorted.push_back(column[id]);
+        }
+        column = std::move(sorted);
+    }
+
+    std::vector<uint16_t> m_depth;
+    std::vector<uint32_t> m_entries;
+    std::vector<int64_t> m_mtime;
+    std::vector<uint32_t> m_owner;
+};
+} // namespace columns
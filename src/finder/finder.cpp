@@ -1,41 +1,115 @@
 module;
 
 #include <algorithm>
+#include <atomic>
 #include <barrier>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <curses.h>
 #include <filesystem>
-#include <set>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
 #include <stop_token>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
+#include <variant>
 #include <vector>
 
 export module finder;
+import columns;
 import tui;
 import parser;
+import pattern;
+import query;
+import radix;
+import store;
+import trigram;
+import unicode;
+import vfs;
+import walk;
 
 namespace fs = std::filesystem;
 
 namespace finder
 {
 /**
- * Class to handle searching
+ * Search string length that can be typed without allocating
  */
-export class Finder
+constexpr size_t SEARCH_CAPACITY{256};
+
+/**
+ * Entry of the key column for folders that are matched as stored
+ */
+constexpr uint32_t NO_KEY{UINT32_MAX};
+
+/**
+ * Folders a top level directory may yield before the rest of it is deferred behind other directories
+ */
+constexpr size_t WALK_BUDGET{10000};
+
+/**
+ * Interval between frames showing the folders found so far while walking
+ */
+constexpr auto PROGRESS_INTERVAL{std::chrono::milliseconds(50)};
+
+/**
+ * Class to handle searching.
+ * Buffers used when handling a keystroke are preallocated once all folders are found,
+ * so that updating the search and drawing the results does not allocate.
+ * Paths and the search are matched in their UTF-8 NFC form, case folded with -i.
+ * Paths whose form differs from the stored bytes get it computed once at index
+ * time, ASCII paths are matched as stored.
+ * The tree view lists folders below their parent folders instead, every folder
+ * with a match in its subtree is a node counting those matches.
+ * @tparam FS filesystem backend folders are read from
+ */
+export template <typename FS = vfs::Native>
+class Finder
 {
   public:
     /**
      * @param tui_p terminal user interface
      * @param root path to search from
+     * @param cmds commands changing storage, indexing and matching
+     * @param filters folder attributes every match must satisfy
+     * @param search initial search string
+     */
+    explicit Finder(auto& tui, fs::path root, const std::vector<parser::Command>& cmds, parser::Filters filters = {}, std::string search = "")
+        : Finder(FS(), tui, std::move(root), cmds, std::move(filters), std::move(search))
+    {
+    }
+
+    /**
+     * @param filesystem backend to read folders from
+     * @param tui_p terminal user interface
+     * @param root path to search from
+     * @param cmds commands changing storage, indexing and matching
+     * @param filters folder attributes every match must satisfy
      * @param search initial search string
      */
-    explicit Finder(auto& tui, fs::path root, const std::vector<parser::Command>& cmds, std::string search = "")
-        : m_root(std::move(root)), m_cmds(cmds), m_search(std::move(search)), m_search_thread([&, this](const std::stop_token& stop_token) { find_folders(stop_token, tui); }), m_input_barrier(2)
+    Finder(FS filesystem, auto& tui, fs::path root, const std::vector<parser::Command>& cmds, parser::Filters filters = {}, std::string search = "")
+        : m_fs(std::move(filesystem)), m_root(std::move(root)), m_cmds(cmds), m_filters(std::move(filters)), m_input(std::move(search)), m_search(m_input), m_folders(std::ranges::find(m_cmds, parser::Command::COMPACT) != m_cmds.end()), m_fold(std::ranges::find(m_cmds, parser::Command::ICASE) != m_cmds.end()), m_use_index(std::ranges::find(m_cmds, parser::Command::TRIGRAM) != m_cmds.end()), m_tree(std::ranges::find(m_cmds, parser::Command::TREE) != m_cmds.end()), m_input_barrier(2, Handover{this})
     {
-        tui.draw_input(m_search);
+        m_input.reserve(SEARCH_CAPACITY);
+        m_search.reserve(SEARCH_CAPACITY);
+        m_normalized.reserve(2 * SEARCH_CAPACITY);
+        m_plan.reserve(m_normalized.capacity());
+        if (std::ranges::find(m_cmds, parser::Command::GLOB) != m_cmds.end())
+        {
+            m_pattern.emplace(pattern::Syntax::GLOB);
+        }
+        else if (std::ranges::find(m_cmds, parser::Command::REGEX) != m_cmds.end())
+        {
+            m_pattern.emplace(pattern::Syntax::REGEX);
+        }
+        m_search_thread = std::jthread([&, this](const std::stop_token& stop_token) { find_folders(stop_token, tui); });
+        tui.draw_input(m_input);
     }
 
     ~Finder()
@@ -46,51 +120,51 @@ export class Finder
     }
 
     /**
-     * Append character to search
-     * @param new_char character to append
+     * Append byte of a UTF-8 character to search, the search is updated once the character is complete
+     * @param new_char byte to append, 0 to remove the last character
      */
     void update_search(char new_char, auto& tui)
     {
-        if (new_char == 0 && !m_search.empty())
+        if (new_char == 0)
         {
-            m_search.pop_back();
+            while (!m_input.empty() && unicode::continuation(m_input.back()))
+            {
+                m_input.pop_back();
+            }
+            if (!m_input.empty())
+            {
+                m_input.pop_back();
+            }
         }
         else
         {
-            m_search.push_back(new_char);
+            m_input.push_back(new_char);
+            if (!unicode::complete(m_input))
+            {
+                return;
+            }
         }
         m_input_barrier.arrive_and_wait();
-        tui.draw_input(m_search);
+        tui.draw_input(m_input);
     }
 
     /**
-     * Inc/Dec selected item
+     * Inc/Dec selected item, moved by the search thread since it rebuilds the matches
      * @param inc if<0 => item--, if>0 => item++
      */
     void update_index(int inc)
     {
-        if (inc < 0)
-        {
-            if (m_index != 0)
-            {
-                m_index--;
-            }
-            else
-            {
-                m_index = m_matches.size() - 1;
-            }
-        }
-        else if (inc > 0)
-        {
-            if (m_index < m_matches.size() - 1)
-            {
-                m_index++;
-            }
-            else
-            {
-                m_index = 0;
-            }
-        }
+        m_input_move = inc;
+        m_input_barrier.arrive_and_wait();
+    }
+
+    /**
+     * Folds the selected folder of the tree view, ignored by the flat view
+     * @param toggle expand or collapse
+     */
+    void update_fold(parser::Toggle toggle)
+    {
+        m_input_toggle = toggle;
         m_input_barrier.arrive_and_wait();
     }
 
@@ -107,33 +181,237 @@ export class Finder
         return m_match;
     }
 
+    /**
+     * @return bool true once all folders are found and the first frame of them is drawn
+     */
+    [[nodiscard]] bool indexed() const
+    {
+        return m_indexed;
+    }
+
+    /**
+     * Retrieves memory used per stored folder path, 0 until all folders are found
+     * @return double bytes per candidate
+     */
+    [[nodiscard]] double bytes_per_candidate() const
+    {
+        return m_bytes_per_candidate;
+    }
+
   private:
+    /**
+     * Hands the input over to the search thread once both threads wait at the barrier,
+     * so neither thread touches the state of the other while it works
+     */
+    struct Handover
+    {
+        Finder* finder;
+
+        void operator()() const noexcept
+        {
+            finder->m_search.assign(finder->m_input);
+            finder->m_move = std::exchange(finder->m_input_move, 0);
+            finder->m_toggle = std::exchange(finder->m_input_toggle, std::nullopt);
+        }
+    };
+
     void find_folders(const std::stop_token& stop_token, auto& tui);
 
+    void match(uint32_t id, std::string_view path);
+
+    [[nodiscard]] std::pair<size_t, size_t> highlight(uint32_t id, std::string_view path);
+
+    [[nodiscard]] std::string_view key(uint32_t id, std::string_view path);
+
+    void normalize_folders();
+
+    void compile();
+
+    void draw(auto& tui);
+
+    void draw_progress(auto& tui, std::string_view names, const std::vector<size_t>& ends);
+
+    void apply_filters(const std::vector<uint32_t>& order);
+
+    void build_tree(const std::vector<uint32_t>& order, const std::vector<uint32_t>& parents);
+
+    void update_counts();
+
+    void fold();
+
+    void flatten();
+
+    FS m_fs;
     fs::path m_root;
     const std::vector<parser::Command> m_cmds;
+    const parser::Filters m_filters;
+    // Input as received by the input thread, handed over to the search thread at the barrier
+    std::string m_input;
+    int m_input_move{0};
+    std::optional<parser::Toggle> m_input_toggle;
     std::string m_search;
+    std::string m_normalized;
+    query::Plan m_plan;
+    std::optional<pattern::Automaton> m_pattern;
     size_t m_index{0};
+    int m_move{0};
+    size_t m_offset{0};
     std::string m_match;
-    std::set<std::string> m_matches;
+    std::vector<uint32_t> m_matches;
+    store::Store m_folders;
+    std::atomic<double> m_bytes_per_candidate{0};
+    std::atomic<bool> m_indexed{false};
+    std::vector<tui::Row> m_rows;
+    std::vector<std::string> m_row_buffers;
+
+    // Highlight spans of the drawn rows, row i shows m_spans[offset, offset + count) for
+    // m_row_spans[i] = {offset, count}. Rows that stay visible for m_highlight_search copy
+    // their spans from the previous frame instead of matching again. Buffers are sized for
+    // the worst case of a frame so only the cache of visible rows is ever kept.
+    std::string m_highlight_search;
+    std::vector<uint32_t> m_row_ids;
+    std::vector<uint32_t> m_previous_row_ids;
+    std::vector<std::pair<size_t, size_t>> m_row_spans;
+    std::vector<std::pair<size_t, size_t>> m_previous_row_spans;
+    std::vector<tui::Span> m_spans;
+    std::vector<tui::Span> m_previous_spans;
 
+    // Normalized forms of the paths that differ from their stored bytes, the form of
+    // folder id is m_keys[m_key_index[id]] unless that is NO_KEY. m_key_index stays
+    // empty while no folder has a differing form.
+    bool m_fold;
+    std::vector<uint32_t> m_key_index;
+    store::Store m_keys;
+    std::string m_key_buffer;
+    std::string m_form;
+    std::vector<uint32_t> m_form_offsets;
+
+    bool m_use_index;
+    trigram::Index m_trigrams;
+    std::vector<uint32_t> m_candidates;
+
+    // Tree view, children of a folder are m_children[m_child_begins[id], m_child_begins[id + 1]),
+    // the children of m_folders.size() are the top level folders. m_counts holds the matches
+    // in the subtree of every folder and is updated along the parents of the folders whose
+    // match state changed since m_previous, m_visible holds the folders of the drawn tree.
+    bool m_tree;
+    std::vector<uint32_t> m_parents;
+    std::vector<uint32_t> m_child_begins;
+    std::vector<uint32_t> m_children;
+    std::vector<uint32_t> m_counts;
+    std::vector<uint8_t> m_matched;
+    std::vector<uint8_t> m_expanded;
+    std::vector<uint32_t> m_previous;
+    std::vector<uint32_t> m_visible;
+    std::vector<std::pair<uint32_t, uint32_t>> m_frames;
+    std::optional<parser::Toggle> m_toggle;
+
+    // Metadata of every folder, only collected if filters are given.
+    // m_allowed holds the ids of m_mask that pass all filters.
+    columns::Columns m_columns;
+    std::vector<uint8_t> m_mask;
+    std::vector<uint32_t> m_allowed;
+
+    std::barrier<Handover> m_input_barrier;
     std::jthread m_search_thread;
-    std::barrier<> m_input_barrier;
 };
 
-void Finder::find_folders(const std::stop_token& stop_token, auto& tui)
+template <typename FS>
+void Finder<FS>::find_folders(const std::stop_token& stop_token, auto& tui)
 {
-    auto folder_iter = fs::recursive_directory_iterator(m_root);
-    std::set<std::string> non_matches;
-    for (const auto& entry : folder_iter)
+    // Folders are collected unsorted into one buffer and ordered by a radix sort afterwards,
+    // until then the folders found so far are drawn in the order they were found
+    walk::Walker walker(m_fs, m_root, WALK_BUDGET, m_filters.changed_within || m_filters.owner);
+    std::string names;
+    std::vector<size_t> ends;
+    std::vector<uint32_t> parents;
+    auto collect = [&](std::string_view folder, size_t depth, uint32_t parent) {
+        names.append(folder);
+        ends.push_back(names.size());
+        if (!m_filters.empty())
+        {
+            m_columns.add(depth);
+        }
+        if (m_tree)
+        {
+            parents.push_back(parent);
+        }
+    };
+    auto describe = [&](uint32_t id, const walk::Metadata& metadata) {
+        if (!m_filters.empty())
+        {
+            m_columns.set(id, metadata.entries, metadata.mtime, metadata.owner);
+        }
+    };
+    auto next_frame = std::chrono::steady_clock::now();
+    while (!stop_token.stop_requested() && walker.step(collect, describe))
+    {
+        if (std::chrono::steady_clock::now() >= next_frame)
+        {
+            draw_progress(tui, names, ends);
+            next_frame = std::chrono::steady_clock::now() + PROGRESS_INTERVAL;
+        }
+    }
+    if (stop_token.stop_requested())
     {
-        if (fs::status(entry.path()).type() == fs::file_type::directory)
+        return;
+    }
+
+    std::vector<std::string_view> folders;
+    folders.reserve(ends.size());
+    for (size_t begin = 0; auto end : ends)
+    {
+        folders.emplace_back(names.data() + begin, end - begin);
+        begin = end;
+    }
+    auto order = radix::sort(folders);
+    for (auto id : order)
+    {
+        m_folders.push_back(folders[id]);
+    }
+    m_folders.finalize();
+    // The walk buffers would otherwise live as long as the session, release them before measuring
+    auto release = [](auto& buffer) {
+        buffer.clear();
+        buffer.shrink_to_fit();
+    };
+    release(folders);
+    release(names);
+    release(ends);
+    apply_filters(order);
+    build_tree(order, parents);
+    release(order);
+    release(parents);
+    normalize_folders();
+    if (m_folders.size() != 0)
+    {
+        auto bytes = m_folders.bytes() + m_keys.bytes() + m_key_index.capacity() * sizeof(uint32_t) + m_columns.bytes();
+        m_bytes_per_candidate = static_cast<double>(bytes) / static_cast<double>(m_folders.size());
+    }
+    if (m_use_index)
+    {
+        m_folders.for_each([this](uint32_t id, std::string_view path) { m_trigrams.add(id, key(id, path)); });
+        m_trigrams.finalize();
+    }
+    m_matches.reserve(m_folders.size());
+    m_candidates.reserve(m_use_index ? m_folders.size() : 0);
+    m_match.reserve(m_folders.max_length());
+    m_highlight_search.reserve(SEARCH_CAPACITY);
+    m_key_buffer.reserve(m_keys.max_length());
+    m_form.reserve(m_keys.max_length());
+    m_form_offsets.reserve(m_keys.max_length() + 1);
+    for (uint32_t id = 0; id < m_folders.size(); id++)
+    {
+        if (m_filters.empty() || m_mask[id] != 0)
         {
-            m_matches.insert(fs::relative(entry.path(), m_root));
+            m_matches.push_back(id);
         }
     }
-    m_match = *m_matches.begin();
-    tui.draw_matches(m_index, m_matches, m_matches.size());
+    compile();
+    update_counts();
+    flatten();
+    draw(tui);
+    m_indexed = true;
 
     while (!stop_token.stop_requested())
     {
@@ -143,43 +421,494 @@ void Finder::find_folders(const std::stop_token& stop_token, auto& tui)
             break;
         }
         {
-            for (auto iter = non_matches.begin(); iter != non_matches.end();)
+            m_matches.clear();
+            compile();
+            auto match = [this](uint32_t id, std::string_view path) { this->match(id, path); };
+            auto literal = m_pattern ? m_pattern->literal() : m_plan.literal();
+            if (m_use_index && literal.size() >= trigram::MIN_QUERY)
             {
-                if (iter->find(m_search) != std::string::npos)
-                {
-                    m_matches.insert(*iter);
-                    iter = non_matches.erase(iter);
-                }
-                else
+                m_trigrams.query(literal, m_candidates);
+                if (!m_filters.empty())
                 {
-                    iter++;
+                    std::erase_if(m_candidates, [this](uint32_t id) { return m_mask[id] == 0; });
                 }
+                m_folders.for_each(m_candidates, match);
+            }
+            else if (!m_filters.empty())
+            {
+                m_folders.for_each(m_allowed, match);
+            }
+            else
+            {
+                m_folders.for_each(match);
             }
 
-            size_t index{0};
-            for (auto iter = m_matches.begin(); iter != m_matches.end();)
+            update_counts();
+            fold();
+            flatten();
+            auto size = m_tree ? m_visible.size() : m_matches.size();
+            if (size <= m_index)
             {
-                if (iter->find(m_search) == std::string::npos)
-                {
-                    non_matches.insert(*iter);
-                    iter = m_matches.erase(iter);
-                }
-                else
-                {
-                    if (index == m_index)
-                    {
-                        m_match = *iter;
-                    }
-                    index++;
-                    iter++;
-                }
+                m_index = size == 0 ? 0 : size - 1;
+            }
+            auto move = std::exchange(m_move, 0);
+            if (move < 0 && size != 0)
+            {
+                m_index = m_index != 0 ? m_index - 1 : size - 1;
             }
-            if (m_matches.size() <= m_index)
+            else if (move > 0 && size != 0)
             {
-                m_index = m_matches.size() - 1;
+                m_index = m_index + 1 < size ? m_index + 1 : 0;
             }
-            tui.draw_matches(m_index, m_matches, m_matches.size() + non_matches.size());
+            draw(tui);
+        }
+    }
+}
+
+/**
+ * Sorts the folder metadata like m_folders and runs the filters over its columns once,
+ * searches then only match the folders that passed
+ * @param order walk order number of each stored folder
+ */
+template <typename FS>
+void Finder<FS>::apply_filters(const std::vector<uint32_t>& order)
+{
+    if (m_filters.empty())
+    {
+        return;
+    }
+    m_columns.permute(order);
+    columns::Filter filter;
+    constexpr size_t MAX_DEPTH{std::numeric_limits<uint16_t>::max()};
+    filter.min_depth = static_cast<uint16_t>(std::min(m_filters.min_depth.value_or(0), MAX_DEPTH));
+    filter.max_depth = static_cast<uint16_t>(std::min(m_filters.max_depth.value_or(MAX_DEPTH), MAX_DEPTH));
+    filter.min_entries = static_cast<uint32_t>(std::min<size_t>(m_filters.min_entries.value_or(0), std::numeric_limits<uint32_t>::max()));
+    if (m_filters.changed_within)
+    {
+        auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+        filter.min_mtime = (now - *m_filters.changed_within).count();
+    }
+    filter.owner = m_filters.owner;
+    m_columns.scan(filter, m_mask);
+
+    m_allowed.reserve(static_cast<size_t>(std::ranges::count(m_mask, 1)));
+    for (uint32_t id = 0; id < m_mask.size(); id++)
+    {
+        if (m_mask[id] != 0)
+        {
+            m_allowed.push_back(id);
         }
     }
 }
+
+/**
+ * Links every folder to its parent and children for the tree view
+ * @param order walk order number of each stored folder
+ * @param parents walk order number of the parent of each folder in walk order, walk::ROOT for top level folders
+ */
+template <typename FS>
+void Finder<FS>::build_tree(const std::vector<uint32_t>& order, const std::vector<uint32_t>& parents)
+{
+    if (!m_tree)
+    {
+        return;
+    }
+    auto size = static_cast<uint32_t>(order.size());
+    std::vector<uint32_t> ids(size);
+    for (uint32_t id = 0; id < size; id++)
+    {
+        ids[order[id]] = id;
+    }
+
+    // Parents sort before their children, so depths and child counts are known in one pass
+    std::vector<uint32_t> depths(size);
+    uint32_t max_depth{0};
+    m_parents.resize(size);
+    m_child_begins.assign(size + 2, 0);
+    for (uint32_t id = 0; id < size; id++)
+    {
+        auto parent = parents[order[id]];
+        m_parents[id] = parent == walk::ROOT ? walk::ROOT : ids[parent];
+        depths[id] = parent == walk::ROOT ? 0 : depths[m_parents[id]] + 1;
+        max_depth = std::max(max_depth, depths[id]);
+        m_child_begins[(parent == walk::ROOT ? size : m_parents[id]) + 1]++;
+    }
+    std::partial_sum(m_child_begins.begin(), m_child_begins.end(), m_child_begins.begin());
+    auto next = m_child_begins;
+    m_children.resize(size);
+    for (uint32_t id = 0; id < size; id++)
+    {
+        m_children[next[m_parents[id] == walk::ROOT ? size : m_parents[id]]++] = id;
+    }
+
+    m_counts.assign(size, 0);
+    m_matched.assign(size, 0);
+    m_expanded.assign(size, 0);
+    m_previous.reserve(size);
+    m_visible.reserve(size);
+    m_frames.reserve(max_depth + 2);
+}
+
+/**
+ * Updates the subtree match counts of the tree view along the parents of every
+ * folder that started or stopped matching since the previous search
+ */
+template <typename FS>
+void Finder<FS>::update_counts()
+{
+    if (!m_tree)
+    {
+        return;
+    }
+    auto count = [this](uint32_t id, bool matched) {
+        m_matched[id] = matched ? 1 : 0;
+        for (auto node = id; node != walk::ROOT; node = m_parents[node])
+        {
+            m_counts[node] = matched ? m_counts[node] + 1 : m_counts[node] - 1;
+        }
+    };
+    // Both match lists are sorted, so the changes are found by merging them
+    size_t previous{0};
+    size_t current{0};
+    while (previous < m_previous.size() || current < m_matches.size())
+    {
+        if (current == m_matches.size() || (previous < m_previous.size() && m_previous[previous] < m_matches[current]))
+        {
+            count(m_previous[previous++], false);
+        }
+        else if (previous == m_previous.size() || m_matches[current] < m_previous[previous])
+        {
+            count(m_matches[current++], true);
+        }
+        else
+        {
+            previous++;
+            current++;
+        }
+    }
+    m_previous.assign(m_matches.begin(), m_matches.end());
+}
+
+/**
+ * Applies the pending fold to the selected folder of the last drawn tree.
+ * Collapsing a folder that shows no children selects its parent.
+ */
+template <typename FS>
+void Finder<FS>::fold()
+{
+    auto toggle = std::exchange(m_toggle, std::nullopt);
+    if (!m_tree || !toggle || m_index >= m_visible.size())
+    {
+        return;
+    }
+    auto id = m_visible[m_index];
+    if (*toggle == parser::Toggle::EXPAND)
+    {
+        m_expanded[id] = 1;
+    }
+    else if (m_expanded[id] != 0 && m_counts[id] > m_matched[id])
+    {
+        m_expanded[id] = 0;
+    }
+    else if (m_parents[id] != walk::ROOT)
+    {
+        while (m_index != 0 && m_visible[m_index] != m_parents[id])
+        {
+            m_index--;
+        }
+    }
+}
+
+/**
+ * Lists the folders of the tree view in drawing order, depth first through the
+ * expanded folders and skipping subtrees without matches
+ */
+template <typename FS>
+void Finder<FS>::flatten()
+{
+    if (!m_tree)
+    {
+        return;
+    }
+    m_visible.clear();
+    auto root = static_cast<uint32_t>(m_folders.size());
+    m_frames.emplace_back(root, m_child_begins[root]);
+    while (!m_frames.empty())
+    {
+        auto& [id, next] = m_frames.back();
+        if (next == m_child_begins[id + 1])
+        {
+            m_frames.pop_back();
+            continue;
+        }
+        auto child = m_children[next++];
+        if (m_counts[child] == 0)
+        {
+            continue;
+        }
+        m_visible.push_back(child);
+        if (m_expanded[child] != 0 && m_counts[child] > m_matched[child])
+        {
+            m_frames.emplace_back(child, m_child_begins[child]);
+        }
+    }
+}
+
+/**
+ * Stores the normalized form of every folder path that differs from its stored bytes,
+ * ASCII paths are skipped without decoding them
+ */
+template <typename FS>
+void Finder<FS>::normalize_folders()
+{
+    std::string form;
+    m_folders.for_each([&](uint32_t id, std::string_view path) {
+        if (unicode::plain(path, m_fold))
+        {
+            return;
+        }
+        unicode::normalize(path, m_fold, form);
+        if (form != path)
+        {
+            if (m_key_index.empty())
+            {
+                m_key_index.assign(m_folders.size(), NO_KEY);
+            }
+            m_key_index[id] = static_cast<uint32_t>(m_keys.size());
+            m_keys.push_back(form);
+        }
+    });
+    m_keys.finalize();
+}
+
+/**
+ * Retrieves the form of a folder that is matched against the search
+ * @param id index of folder in m_folders
+ * @param path stored folder path
+ * @return std::string_view normalized path if it differs from path, else path
+ */
+template <typename FS>
+std::string_view Finder<FS>::key(uint32_t id, std::string_view path)
+{
+    if (m_key_index.empty() || m_key_index[id] == NO_KEY)
+    {
+        return path;
+    }
+    return m_keys.get(m_key_index[id], m_key_buffer);
+}
+
+/**
+ * Feeds user input to finder until the user enters or escapes
+ * @param finder finder to update
+ * @param tui terminal user interface to read input from
+ * @return bool true if the user entered a match, false if escaped
+ */
+export template <typename FS>
+bool run(Finder<FS>& finder, auto& tui)
+{
+    while (true)
+    {
+        auto input = parser::get_input(tui);
+        if (!input)
+        {
+            continue;
+        }
+        if (const auto* match = std::get_if<char>(&input.value()))
+        {
+            finder.update_search(*match, tui);
+        }
+        else if (const auto* toggle = std::get_if<parser::Toggle>(&input.value()))
+        {
+            finder.update_fold(*toggle);
+        }
+        else if (const auto* index = std::get_if<int>(&input.value()))
+        {
+            finder.update_index(*index);
+        }
+        else if (const auto* finish = std::get_if<bool>(&input.value()))
+        {
+            return *finish;
+        }
+    }
+}
+
+/**
+ * Normalizes the search string like the folder paths and compiles it to the glob
+ * or regex automaton or the query plan
+ */
+template <typename FS>
+void Finder<FS>::compile()
+{
+    unicode::normalize(m_search, m_fold, m_normalized);
+    if (m_pattern)
+    {
+        m_pattern->compile(m_normalized);
+    }
+    else
+    {
+        m_plan.parse(m_normalized);
+    }
+}
+
+/**
+ * Verifies candidate against the pattern or query plan and collects it on match
+ * @param id index of candidate in m_folders
+ * @param path candidate path
+ */
+template <typename FS>
+void Finder<FS>::match(uint32_t id, std::string_view path)
+{
+    path = key(id, path);
+    if (m_pattern ? m_pattern->matches(path) : m_plan.matches(path))
+    {
+        m_matches.push_back(id);
+    }
+}
+
+/**
+ * Appends the highlight spans of a visible match to m_spans, copied from the previous
+ * frame if the match was visible in it for the same search.
+ * Spans found in the normalized form are mapped back to the stored bytes.
+ * @param id index of match in m_folders
+ * @param path match path
+ * @return std::pair<size_t, size_t> offset and count of the spans in m_spans
+ */
+template <typename FS>
+std::pair<size_t, size_t> Finder<FS>::highlight(uint32_t id, std::string_view path)
+{
+    auto first = m_spans.size();
+    if (auto previous = std::ranges::find(m_previous_row_ids, id); previous != m_previous_row_ids.end())
+    {
+        auto [offset, count] = m_previous_row_spans[static_cast<size_t>(previous - m_previous_row_ids.begin())];
+        m_spans.insert(m_spans.end(), m_previous_spans.begin() + static_cast<std::ptrdiff_t>(offset), m_previous_spans.begin() + static_cast<std::ptrdiff_t>(offset + count));
+        return {first, count};
+    }
+    auto form = key(id, path);
+    if (m_pattern)
+    {
+        m_pattern->highlight(form, m_spans);
+    }
+    else
+    {
+        m_plan.highlight(form, m_spans);
+    }
+    if (form.data() != path.data())
+    {
+        unicode::normalize(path, m_fold, m_form, &m_form_offsets);
+        for (auto span = first; span < m_spans.size(); span++)
+        {
+            auto& [begin, length] = m_spans[span];
+            auto end = m_form_offsets[begin + length];
+            begin = m_form_offsets[begin];
+            length = end - begin;
+        }
+    }
+    return {first, m_spans.size() - first};
+}
+
+/**
+ * Draws the window of matches around the selected match
+ * @param tui terminal user interface
+ */
+template <typename FS>
+void Finder<FS>::draw(auto& tui)
+{
+    const auto& ids = m_tree ? m_visible : m_matches;
+    auto height = std::max<size_t>(tui.rows(), 1);
+    if (m_index < m_offset)
+    {
+        m_offset = m_index;
+    }
+    else if (m_index >= m_offset + height)
+    {
+        m_offset = m_index - height + 1;
+    }
+    if (m_row_buffers.size() != height)
+    {
+        m_row_buffers.resize(height);
+        for (auto& buffer : m_row_buffers)
+        {
+            buffer.reserve(m_folders.max_length());
+        }
+        m_rows.reserve(height);
+        // Merged spans of a row are separated by at least one byte, the spans of the
+        // last row are merged in place after up to one per search byte
+        auto spans = height * (m_folders.max_length() / 2 + 1) + m_normalized.capacity();
+        for (auto* buffer : {&m_spans, &m_previous_spans})
+        {
+            buffer->clear();
+            buffer->reserve(spans);
+        }
+        for (auto* buffer : {&m_row_ids, &m_previous_row_ids})
+        {
+            buffer->clear();
+            buffer->reserve(height);
+        }
+        for (auto* buffer : {&m_row_spans, &m_previous_row_spans})
+        {
+            buffer->clear();
+            buffer->reserve(height);
+        }
+    }
+    std::swap(m_row_ids, m_previous_row_ids);
+    std::swap(m_row_spans, m_previous_row_spans);
+    std::swap(m_spans, m_previous_spans);
+    if (m_highlight_search != m_search)
+    {
+        m_highlight_search = m_search;
+        m_previous_row_ids.clear();
+    }
+    m_row_ids.clear();
+    m_row_spans.clear();
+    m_spans.clear();
+    m_rows.clear();
+    for (size_t row = 0; row < height && m_offset + row < ids.size(); row++)
+    {
+        auto id = ids[m_offset + row];
+        auto path = m_folders.get(id, m_row_buffers[row]);
+        m_rows.push_back({.text = path, .spans = {}});
+        m_row_ids.push_back(id);
+        if (!m_tree)
+        {
+            m_row_spans.push_back(highlight(id, path));
+            continue;
+        }
+        // Folders only shown as parents of matches are not highlighted
+        m_row_spans.push_back(m_matched[id] != 0 ? highlight(id, path) : std::pair<size_t, size_t>{m_spans.size(), 0});
+        for (auto parent = m_parents[id]; parent != walk::ROOT; parent = m_parents[parent])
+        {
+            m_rows.back().depth++;
+        }
+        m_rows.back().nested = true;
+        m_rows.back().count = m_counts[id] - m_matched[id];
+        m_rows.back().branch = m_rows.back().count == 0 ? tui::Branch::LEAF : m_expanded[id] != 0 ? tui::Branch::EXPANDED : tui::Branch::COLLAPSED;
+    }
+    for (size_t row = 0; row < m_rows.size(); row++)
+    {
+        m_rows[row].spans = std::span(m_spans).subspan(m_row_spans[row].first, m_row_spans[row].second);
+    }
+    if (m_index - m_offset < m_rows.size())
+    {
+        m_match = m_rows[m_index - m_offset].text;
+    }
+    tui.draw_matches(m_index - m_offset, m_rows, m_matches.size(), m_folders.size());
+}
+
+/**
+ * Draws the first folders found while walking, nothing can be selected yet
+ * @param tui terminal user interface
+ * @param names concatenated folder paths
+ * @param ends end offset of each folder path in names
+ */
+template <typename FS>
+void Finder<FS>::draw_progress(auto& tui, std::string_view names, const std::vector<size_t>& ends)
+{
+    auto height = std::max<size_t>(tui.rows(), 1);
+    m_rows.clear();
+    for (size_t row = 0, begin = 0; row < height && row < ends.size(); begin = ends[row++])
+    {
+        m_rows.push_back({.text = names.substr(begin, ends[row] - begin), .spans = {}});
+    }
+    tui.draw_matches(0, m_rows, ends.size(), ends.size());
+}
 } // namespace finder
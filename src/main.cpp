@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <array>
 #include <csignal>
 #include <cstdio>
@@ -7,7 +8,6 @@
 #include <filesystem>
 #include <iostream>
 #include <termios.h>
-#include <variant>
 
 import parser;
 import finder;
@@ -64,32 +64,26 @@ int main(int argc, const char* argv[])
     try
     {
         auto args = parser::get_args(argc, argv);
-        finder::Finder finder(tui, args.path, args.commands);
-        while (true)
+        if (std::ranges::find(args.commands, parser::Command::PREVIEW) != args.commands.end())
         {
-            auto input = parser::get_input(tui);
-            if (!input)
-            {
-                continue;
-            }
-            if (const auto* match = std::get_if<char>(&input.value()))
-            {
-                finder.update_search(*match, tui);
-            }
-            else if (const auto* index = std::get_if<int>(&input.value()))
-            {
-                finder.update_index(*index);
-            }
-            else if (const auto* finish = std::get_if<bool>(&input.value()))
-            {
-                teardown(tty_p, orig_tty);
-                if (*finish)
-                {
-                    std::cout << finder.get_match() << "\n";
-                }
-                return 0;
-            }
+            tui.enable_preview(args.path);
         }
+        if (!args.record.empty())
+        {
+            tui.record(args.record);
+        }
+        finder::Finder finder(tui, args.path, args.commands, args.filters);
+        auto chosen = finder::run(finder, tui);
+        teardown(tty_p, orig_tty);
+        if (chosen)
+        {
+            std::cout << finder.get_match() << "\n";
+        }
+        if (std::ranges::find(args.commands, parser::Command::COMPACT) != args.commands.end())
+        {
+            std::cerr << "fzf-folder: " << finder.bytes_per_candidate() << " bytes per folder\n";
+        }
+        return 0;
     }
     catch (parser::CmdExcept& cmd_except)
     {
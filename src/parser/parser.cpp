@@ -1,13 +1,20 @@
 module;
 
+#include <array>
 #include <cassert>
+#include <charconv>
+#include <chrono>
 #include <csignal>
+#include <cstdint>
 #include <curses.h>
 #include <exception>
 #include <filesystem>
 #include <iostream>
+#include <limits>
 #include <optional>
+#include <pwd.h>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -24,10 +31,50 @@ namespace parser
 export enum class Command : uint8_t
 {
     UKNOWN,
-    ICASE, // Case insensitive (-i)
-    FPATH, // Print full path (-f)
-    PATH,  // Arg is a path
-    HELP,  // Help (-h)
+    ICASE,       // Case insensitive (-i)
+    FPATH,       // Print full path (-f)
+    PATH,        // Arg is a path
+    HELP,        // Help (-h)
+    TRIGRAM,     // Build trigram index (-t)
+    COMPACT,     // Front code stored paths (-c)
+    PREVIEW,     // Show contents of selected folder (-p)
+    RECORD,      // Record keys to file (-r <file>)
+    GLOB,        // Search is a glob pattern (--glob)
+    REGEX,       // Search is a regular expression (--regex)
+    CHANGED,     // Only folders modified within a duration (--changed-within <age>)
+    MIN_DEPTH,   // Only folders at least this deep (--min-depth <n>)
+    MAX_DEPTH,   // Only folders at most this deep (--max-depth <n>)
+    MIN_ENTRIES, // Only folders with at least this many entries (--min-entries <n>)
+    OWNER,       // Only folders owned by user (--owner <user>)
+    TREE,        // Show matches as a tree of folders (--tree)
+};
+
+/**
+ * Folding of the selected folder in the tree view
+ */
+export enum class Toggle : uint8_t
+{
+    COLLAPSE, // Hide the subfolders, or select the parent if already hidden
+    EXPAND,   // Show the subfolders
+};
+
+/**
+ * Folder attribute filters, unset filters accept every folder
+ */
+export struct Filters
+{
+    std::optional<std::chrono::seconds> changed_within;
+    std::optional<size_t> min_depth;
+    std::optional<size_t> max_depth;
+    std::optional<size_t> min_entries;
+    std::optional<uint32_t> owner;
+
+    [[nodiscard]] bool empty() const
+    {
+        return !changed_within && !min_depth && !max_depth && !min_entries && !owner;
+    }
+
+    bool operator==(const Filters&) const = default;
 };
 } // namespace parser
 
@@ -55,6 +102,54 @@ namespace
     {
         return parser::Command::HELP;
     }
+    if (std::string("-t") == arg)
+    {
+        return parser::Command::TRIGRAM;
+    }
+    if (std::string("-c") == arg)
+    {
+        return parser::Command::COMPACT;
+    }
+    if (std::string("-p") == arg)
+    {
+        return parser::Command::PREVIEW;
+    }
+    if (std::string("-r") == arg)
+    {
+        return parser::Command::RECORD;
+    }
+    if (std::string("--glob") == arg)
+    {
+        return parser::Command::GLOB;
+    }
+    if (std::string("--regex") == arg)
+    {
+        return parser::Command::REGEX;
+    }
+    if (std::string("--changed-within") == arg)
+    {
+        return parser::Command::CHANGED;
+    }
+    if (std::string("--min-depth") == arg)
+    {
+        return parser::Command::MIN_DEPTH;
+    }
+    if (std::string("--max-depth") == arg)
+    {
+        return parser::Command::MAX_DEPTH;
+    }
+    if (std::string("--min-entries") == arg)
+    {
+        return parser::Command::MIN_ENTRIES;
+    }
+    if (std::string("--owner") == arg)
+    {
+        return parser::Command::OWNER;
+    }
+    if (std::string("--tree") == arg)
+    {
+        return parser::Command::TREE;
+    }
     return parser::Command::UKNOWN;
 }
 
@@ -68,6 +163,18 @@ void print_help()
                  " - fzf-folder <path>   -Runs tool with <path> as root-directory\n"
                  " - fzf-folder -i       -Case insensitive search\n"
                  " - fzf-folder -f       -Printout full path and not relative\n"
+                 " - fzf-folder -t       -Index folders by trigrams, speeds up ', ^ and $ terms and patterns with 3+ literal characters\n"
+                 " - fzf-folder -c       -Compact low memory storage of folders, reports bytes per folder\n"
+                 " - fzf-folder -p       -Preview contents of the selected folder\n"
+                 " - fzf-folder -r <file> -Record keys and their timing to <file> for replay tests\n"
+                 " - fzf-folder --glob   -Search with glob patterns matching whole paths such as **/services/*/deploy\n"
+                 " - fzf-folder --regex  -Search with regular expressions\n"
+                 " - fzf-folder --tree   -Group matches under their folders, left and right arrows fold them\n"
+                 " - fzf-folder --changed-within <age> -Only folders modified within <age>, such as 30m, 12h, 2d or 1w\n"
+                 " - fzf-folder --min-depth <n>        -Only folders at least <n> levels below root\n"
+                 " - fzf-folder --max-depth <n>        -Only folders at most <n> levels below root\n"
+                 " - fzf-folder --min-entries <n>      -Only folders holding at least <n> files or folders\n"
+                 " - fzf-folder --owner <user>         -Only folders owned by <user>, a name or user id\n"
                  " - fzf-folder -h       -Print this help page\n";
 }
 
@@ -81,6 +188,79 @@ void print_unknown(const char* arg)
                  " - Run fzf-folder -h for a full list of commands\n";
 }
 
+/**
+ * Print missing or invalid value of arg
+ */
+void print_missing(const char* arg)
+{
+    std::cout << "Missing or invalid value for arg: " << arg
+              << "\n"
+                 " - Run fzf-folder -h for a full list of commands\n";
+}
+
+/**
+ * Parses an unsigned number
+ * @return std::optional<size_t> number or nullopt if value is not one
+ */
+[[nodiscard]] std::optional<size_t> parse_number(std::string_view value)
+{
+    size_t number{0};
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+    if (error != std::errc() || end != value.data() + value.size())
+    {
+        return std::nullopt;
+    }
+    return number;
+}
+
+/**
+ * Parses a duration such as 45s, 30m, 12h, 2d or 1w
+ * @return std::optional<std::chrono::seconds> duration or nullopt if value is not one or does not fit
+ */
+[[nodiscard]] std::optional<std::chrono::seconds> parse_age(std::string_view value)
+{
+    if (value.empty())
+    {
+        return std::nullopt;
+    }
+    auto count = parse_number(value.substr(0, value.size() - 1));
+    if (!count)
+    {
+        return std::nullopt;
+    }
+    constexpr std::string_view UNITS{"smhdw"};
+    constexpr std::array<long long, UNITS.size()> SECONDS{1, 60, 60 * 60, 24 * 60 * 60, 7 * 24 * 60 * 60};
+    auto unit = UNITS.find(value.back());
+    if (unit == std::string_view::npos || *count > static_cast<size_t>(std::numeric_limits<long long>::max() / SECONDS.at(unit)))
+    {
+        return std::nullopt;
+    }
+    return std::chrono::seconds(static_cast<long long>(*count) * SECONDS.at(unit));
+}
+
+/**
+ * Parses a user name or id
+ * @return std::optional<uint32_t> user id or nullopt if there is no such user or the id is not below UINT32_MAX,
+ *         which marks folders without a known owner
+ */
+[[nodiscard]] std::optional<uint32_t> parse_owner(const char* value)
+{
+    if (auto uid = parse_number(value))
+    {
+        if (*uid >= std::numeric_limits<uint32_t>::max())
+        {
+            return std::nullopt;
+        }
+        return static_cast<uint32_t>(*uid);
+    }
+    const auto* user = getpwnam(value);
+    if (user == nullptr)
+    {
+        return std::nullopt;
+    }
+    return user->pw_uid;
+}
+
 /**
  * Represents program argument
  */
@@ -88,6 +268,8 @@ struct Args
 {
     fs::path path;
     std::vector<parser::Command> commands;
+    fs::path record;
+    parser::Filters filters;
 };
 } // namespace
 
@@ -130,6 +312,14 @@ export void print_except(const CmdExcept& except) /// NOLINT
     case Command::HELP:
         print_help();
         break;
+    case Command::RECORD:
+    case Command::CHANGED:
+    case Command::MIN_DEPTH:
+    case Command::MAX_DEPTH:
+    case Command::MIN_ENTRIES:
+    case Command::OWNER:
+        print_missing(except.arg());
+        break;
     default:
         print_unknown(except.arg());
         break;
@@ -147,6 +337,8 @@ export [[nodiscard]] Args get_args(int argc, const char* argv[]) /// NOLINT
     Args args{
         .path = fs::current_path(),
         .commands = {},
+        .record = {},
+        .filters = {},
     };
     for (int i = 1; i < argc; i++)
     {
@@ -159,6 +351,43 @@ export [[nodiscard]] Args get_args(int argc, const char* argv[]) /// NOLINT
         case Command::HELP:
             throw CmdExcept(command);
             break;
+        case Command::RECORD:
+            if (i + 1 == argc)
+            {
+                throw CmdExcept(command, argv[i]); /// NOLINT
+            }
+            args.record = fs::path(argv[++i]); /// NOLINT
+            break;
+        case Command::CHANGED:
+        case Command::MIN_DEPTH:
+        case Command::MAX_DEPTH:
+        case Command::MIN_ENTRIES:
+        case Command::OWNER: {
+            const char* value = i + 1 == argc ? nullptr : argv[i + 1]; /// NOLINT
+            bool valid{value != nullptr};
+            if (valid && command == Command::CHANGED)
+            {
+                args.filters.changed_within = parse_age(value);
+                valid = args.filters.changed_within.has_value();
+            }
+            else if (valid && command == Command::OWNER)
+            {
+                args.filters.owner = parse_owner(value);
+                valid = args.filters.owner.has_value();
+            }
+            else if (valid)
+            {
+                auto& number = command == Command::MIN_DEPTH ? args.filters.min_depth : command == Command::MAX_DEPTH ? args.filters.max_depth : args.filters.min_entries;
+                number = parse_number(value);
+                valid = number.has_value();
+            }
+            if (!valid)
+            {
+                throw CmdExcept(command, argv[i]); /// NOLINT
+            }
+            i++;
+            break;
+        }
         case Command::UKNOWN:
             throw CmdExcept(command, argv[i]); /// NOLINT
             break;
@@ -176,9 +405,10 @@ export [[nodiscard]] Args get_args(int argc, const char* argv[]) /// NOLINT
  * @param tui terminal ui to get user input
  * @return char if the user gave a match, 0 if backspace
  *         bool if the user escaped or entered,
- *         int if the user navigated up or down {-1, 1}
+ *         int if the user navigated up or down {-1, 1},
+ *         Toggle if the user folded the selected folder
  */
-export [[nodiscard]] std::optional<std::variant<char, bool, int>> get_input(const auto& tui) /// NOLINT
+export [[nodiscard]] std::optional<std::variant<char, bool, int, Toggle>> get_input(const auto& tui) /// NOLINT
 {
     auto input = tui.get_input();
 
@@ -208,6 +438,18 @@ export [[nodiscard]] std::optional<std::variant<char, bool, int>> get_input(cons
         return -1;
     }
 
+    constexpr int ARROW_LEFT = 260;
+    if (input == ARROW_LEFT)
+    {
+        return Toggle::COLLAPSE;
+    }
+
+    constexpr int ARROW_RIGHT = 261;
+    if (input == ARROW_RIGHT)
+    {
+        return Toggle::EXPAND;
+    }
+
     constexpr int DELETE = 263;
     if (input == DELETE)
     {
@@ -220,6 +462,14 @@ export [[nodiscard]] std::optional<std::variant<char, bool, int>> get_input(cons
     {
         return static_cast<char>(input);
     }
+
+    // Bytes of multi-byte UTF-8 characters arrive one at a time
+    constexpr int MIN_UTF8_BYTE = 128;
+    constexpr int MAX_UTF8_BYTE = 255;
+    if (MIN_UTF8_BYTE <= input && input <= MAX_UTF8_BYTE)
+    {
+        return static_cast<char>(input);
+    }
     return std::nullopt;
 }
 } // namespace parser
@@ -0,0 +1,799 @@
+module;
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module pattern;
+
+namespace
+{
+/**
+ * Number of distinct input bytes, one transition table column each
+ */
+constexpr size_t ALPHABET{256};
+
+/**
+ * Transition or state that has not been constructed yet
+ */
+constexpr int32_t UNKNOWN{-1};
+
+/**
+ * Slots in the open addressed table mapping NFA state sets to DFA states
+ */
+constexpr size_t BUCKETS{1024};
+
+/**
+ * Checks if escaped character c stands for a character class in a regex
+ */
+[[nodiscard]] bool is_class_escape(char c)
+{
+    return c == 'd' || c == 'w' || c == 's';
+}
+
+/**
+ * Bytes matched by a regex class escape
+ * @param c d for digits, w for word characters or s for whitespace
+ */
+[[nodiscard]] std::bitset<ALPHABET> escape_class(char c)
+{
+    std::bitset<ALPHABET> set;
+    for (size_t byte = 0; byte < ALPHABET; byte++)
+    {
+        auto ascii = static_cast<char>(byte);
+        auto digit = ascii >= '0' && ascii <= '9';
+        auto word = digit || (ascii >= 'a' && ascii <= 'z') || (ascii >= 'A' && ascii <= 'Z') || ascii == '_';
+        set[byte] = c == 'd' ? digit : c == 'w' ? word : (ascii == ' ' || ascii == '\t');
+    }
+    return set;
+}
+} // namespace
+
+namespace pattern
+{
+/**
+ * Pattern language of an Automaton
+ */
+export enum class Syntax : uint8_t
+{
+    GLOB,  // Whole path with *, ** across folders, **/ for any parent folders, ?, [abc] and [!abc]
+    REGEX, // . [] * + ? | () \d \w \s and ^ $ at the pattern ends
+};
+
+/**
+ * Glob or regular expression compiled to a lazily constructed DFA.
+ * The pattern is parsed to a Thompson NFA once per search string. DFA states are
+ * sets of NFA states, built the first time a byte leads to them and cached in a
+ * transition table, so testing a path is one table lookup per byte without
+ * backtracking. The cache is flushed when it is full so memory stays bounded.
+ * Globs match the whole path like fnmatch, regexes match anywhere unless anchored.
+ * Empty patterns of either syntax match every path.
+ */
+export class Automaton
+{
+  public:
+    /**
+     * DFA states cached before the cache is flushed
+     */
+    static constexpr size_t MAX_STATES{512};
+
+    /**
+     * NFA nodes a pattern can compile to without allocating
+     */
+    static constexpr size_t MAX_NODES{1024};
+
+    /**
+     * @param syntax pattern language used by compile
+     */
+    explicit Automaton(Syntax syntax) : m_syntax(syntax)
+    {
+        m_nodes.reserve(MAX_NODES);
+        m_marks.reserve(MAX_NODES);
+        m_stack.reserve(MAX_NODES);
+        m_closure.reserve(MAX_NODES);
+        m_states.reserve(MAX_STATES);
+        m_sets.reserve(MAX_STATES * 8);
+        m_table.resize(MAX_STATES * ALPHABET, UNKNOWN);
+        m_buckets.resize(BUCKETS, UNKNOWN);
+        m_literal.reserve(MAX_NODES);
+        m_run.reserve(MAX_NODES);
+    }
+
+    /**
+     * Replaces the automaton with one for pattern
+     * @param pattern glob or regex depending on the syntax
+     * @return bool false if pattern is malformed, nothing matches until the next compile
+     */
+    bool compile(std::string_view pattern)
+    {
+        m_nodes.clear();
+        m_literal.clear();
+        m_run.clear();
+        m_error = false;
+        m_begin_anchor = false;
+        m_end_anchor = false;
+        flush();
+
+        Fragment fragment{};
+        if (m_syntax == Syntax::GLOB)
+        {
+            // An empty glob matches every path like an empty regex, not only the empty one
+            m_begin_anchor = !pattern.empty();
+            m_end_anchor = !pattern.empty();
+            fragment = parse_glob(pattern);
+        }
+        else
+        {
+            if (pattern.starts_with('^'))
+            {
+                m_begin_anchor = true;
+                pattern.remove_prefix(1);
+            }
+            size_t escapes{0};
+            while (escapes + 1 < pattern.size() && pattern[pattern.size() - 2 - escapes] == '\\')
+            {
+                escapes++;
+            }
+            if (pattern.ends_with('$') && escapes % 2 == 0)
+            {
+                m_end_anchor = true;
+                pattern.remove_suffix(1);
+            }
+            m_pattern = pattern;
+            m_pos = 0;
+            fragment = parse_alternation();
+            m_error |= m_pos != m_pattern.size();
+            regex_literal(pattern);
+        }
+        auto match = node(Op::MATCH);
+        at(fragment.end).out = match;
+        m_start = fragment.begin;
+        m_marks.assign(m_nodes.size(), 0);
+        m_generation = 0;
+        if (m_error)
+        {
+            m_literal.clear();
+        }
+        return !m_error;
+    }
+
+    /**
+     * Checks if the pattern matches anywhere in path
+     * @param path candidate path
+     */
+    [[nodiscard]] bool matches(std::string_view path)
+    {
+        if (m_error)
+        {
+            return false;
+        }
+        auto search = !m_begin_anchor;
+        auto state = start(search);
+        for (auto byte : path)
+        {
+            if (m_states[static_cast<size_t>(state)].accept && !m_end_anchor)
+            {
+                return true;
+            }
+            state = step(state, static_cast<uint8_t>(byte));
+            if (!search && m_states[static_cast<size_t>(state)].size == 0)
+            {
+                return false;
+            }
+        }
+        return m_states[static_cast<size_t>(state)].accept;
+    }
+
+    /**
+     * Retrieves text every match must contain, usable for index lookups
+     * @return std::string_view literal or empty if none is known
+     */
+    [[nodiscard]] std::string_view literal() const
+    {
+        return m_literal;
+    }
+
+    /**
+     * Appends the leftmost longest match in path
+     * @param path matching path
+     * @param spans container of structs with begin and length members
+     */
+    void highlight(std::string_view path, auto& spans)
+    {
+        if (m_error)
+        {
+            return;
+        }
+        for (size_t begin = 0; begin <= path.size(); begin++)
+        {
+            auto end = longest(path, begin);
+            if (end != std::string_view::npos)
+            {
+                if (end != begin)
+                {
+                    spans.push_back({.begin = begin, .length = end - begin});
+                }
+                return;
+            }
+            if (m_begin_anchor)
+            {
+                return;
+            }
+        }
+    }
+
+  private:
+    enum class Op : uint8_t
+    {
+        BYTE,  // Consumes a byte in bytes and continues at out
+        SPLIT, // Continues at out and alt without consuming, either may be unset
+        MATCH, // Pattern matched
+    };
+
+    struct Node
+    {
+        Op op{Op::SPLIT};
+        std::bitset<ALPHABET> bytes;
+        int32_t out{UNKNOWN};
+        int32_t alt{UNKNOWN};
+    };
+
+    /**
+     * Partial NFA, end is a SPLIT node without successors yet
+     */
+    struct Fragment
+    {
+        int32_t begin;
+        int32_t end;
+    };
+
+    /**
+     * DFA state, the sorted BYTE and MATCH nodes in m_sets[begin, begin + size)
+     */
+    struct State
+    {
+        uint32_t begin;
+        uint32_t size;
+        bool accept;
+        bool search;
+    };
+
+    int32_t node(Op op, const std::bitset<ALPHABET>& bytes = {}, int32_t out = UNKNOWN, int32_t alt = UNKNOWN)
+    {
+        m_nodes.push_back({.op = op, .bytes = bytes, .out = out, .alt = alt});
+        return static_cast<int32_t>(m_nodes.size() - 1);
+    }
+
+    Node& at(int32_t index)
+    {
+        return m_nodes[static_cast<size_t>(index)];
+    }
+
+    Fragment empty()
+    {
+        auto end = node(Op::SPLIT);
+        return {.begin = end, .end = end};
+    }
+
+    Fragment bytes(const std::bitset<ALPHABET>& set)
+    {
+        auto end = node(Op::SPLIT);
+        return {.begin = node(Op::BYTE, set, end), .end = end};
+    }
+
+    Fragment concat(Fragment first, Fragment second)
+    {
+        at(first.end).out = second.begin;
+        return {.begin = first.begin, .end = second.end};
+    }
+
+    Fragment alternate(Fragment first, Fragment second)
+    {
+        auto end = node(Op::SPLIT);
+        at(first.end).out = end;
+        at(second.end).out = end;
+        return {.begin = node(Op::SPLIT, {}, first.begin, second.begin), .end = end};
+    }
+
+    Fragment star(Fragment fragment)
+    {
+        auto end = node(Op::SPLIT);
+        auto loop = node(Op::SPLIT, {}, fragment.begin, end);
+        at(fragment.end).out = loop;
+        return {.begin = loop, .end = end};
+    }
+
+    Fragment plus(Fragment fragment)
+    {
+        auto end = node(Op::SPLIT);
+        auto loop = node(Op::SPLIT, {}, fragment.begin, end);
+        at(fragment.end).out = loop;
+        return {.begin = fragment.begin, .end = end};
+    }
+
+    Fragment optional(Fragment fragment)
+    {
+        auto end = node(Op::SPLIT);
+        at(fragment.end).out = end;
+        return {.begin = node(Op::SPLIT, {}, fragment.begin, end), .end = end};
+    }
+
+    /**
+     * Fragment matching one character out of set. Bytes of set above ASCII stand
+     * for every multi-byte UTF-8 sequence, so that ? and . consume whole characters.
+     */
+    Fragment character(std::bitset<ALPHABET> set)
+    {
+        constexpr size_t ASCII{0x80};
+        auto range = [](size_t low, size_t high) {
+            std::bitset<ALPHABET> bytes;
+            for (auto byte = low; byte <= high; byte++)
+            {
+                bytes.set(byte);
+            }
+            return bytes;
+        };
+        if ((set & range(ASCII, ALPHABET - 1)).none())
+        {
+            return bytes(set);
+        }
+        set &= range(0, ASCII - 1);
+        auto continuation = range(0x80, 0xBF);
+        auto fragment = alternate(bytes(set), concat(bytes(range(0xC2, 0xDF)), bytes(continuation)));
+        fragment = alternate(fragment, concat(concat(bytes(range(0xE0, 0xEF)), bytes(continuation)), bytes(continuation)));
+        return alternate(fragment, concat(concat(concat(bytes(range(0xF0, 0xF4)), bytes(continuation)), bytes(continuation)), bytes(continuation)));
+    }
+
+    static std::bitset<ALPHABET> single(char c)
+    {
+        std::bitset<ALPHABET> set;
+        set.set(static_cast<uint8_t>(c));
+        return set;
+    }
+
+    /**
+     * Parses a bracket expression starting after '[' in pattern at pos
+     * @return bool false if the bracket is not closed
+     */
+    bool parse_class(std::string_view pattern, size_t& pos, std::bitset<ALPHABET>& set) const
+    {
+        bool negate{false};
+        if (pos < pattern.size() && (pattern[pos] == '^' || (m_syntax == Syntax::GLOB && pattern[pos] == '!')))
+        {
+            negate = true;
+            pos++;
+        }
+        for (bool first = true; pos < pattern.size() && (pattern[pos] != ']' || first); first = false)
+        {
+            auto low = static_cast<uint8_t>(pattern[pos++]);
+            if (low == '\\' && pos < pattern.size())
+            {
+                low = static_cast<uint8_t>(pattern[pos++]);
+            }
+            if (pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']')
+            {
+                auto high = static_cast<uint8_t>(pattern[pos + 1]);
+                pos += 2;
+                for (auto byte = static_cast<size_t>(low); byte <= high; byte++)
+                {
+                    set.set(byte);
+                }
+            }
+            else
+            {
+                set.set(low);
+            }
+        }
+        if (pos == pattern.size())
+        {
+            return false;
+        }
+        pos++;
+        if (negate)
+        {
+            set.flip();
+        }
+        return true;
+    }
+
+    Fragment parse_glob(std::string_view pattern)
+    {
+        auto any = std::bitset<ALPHABET>().set();
+        auto segment = any;
+        segment.reset('/');
+
+        auto fragment = empty();
+        for (size_t pos = 0; pos < pattern.size();)
+        {
+            auto c = pattern[pos++];
+            std::bitset<ALPHABET> set;
+            if (c == '*')
+            {
+                auto first = pos - 1;
+                bool deep = pos < pattern.size() && pattern[pos] == '*';
+                while (pos < pattern.size() && pattern[pos] == '*')
+                {
+                    pos++;
+                }
+                commit();
+                // **/ also matches no folder at all, so **/deploy finds deploy at the root
+                if (deep && pos < pattern.size() && pattern[pos] == '/' && (first == 0 || pattern[first - 1] == '/'))
+                {
+                    pos++;
+                    fragment = concat(fragment, optional(concat(star(bytes(any)), bytes(single('/')))));
+                    continue;
+                }
+                fragment = concat(fragment, star(bytes(deep ? any : segment)));
+                continue;
+            }
+            if (c == '?')
+            {
+                commit();
+                fragment = concat(fragment, character(segment));
+                continue;
+            }
+            if (auto end = pos; c == '[' && parse_class(pattern, end, set))
+            {
+                pos = end;
+                commit();
+                fragment = concat(fragment, character(set & segment));
+                continue;
+            }
+            if (c == '\\' && pos < pattern.size())
+            {
+                c = pattern[pos++];
+            }
+            m_run.push_back(c);
+            fragment = concat(fragment, bytes(single(c)));
+        }
+        commit();
+        return fragment;
+    }
+
+    Fragment parse_alternation()
+    {
+        auto fragment = parse_concat();
+        while (m_pos < m_pattern.size() && m_pattern[m_pos] == '|')
+        {
+            m_pos++;
+            fragment = alternate(fragment, parse_concat());
+        }
+        return fragment;
+    }
+
+    Fragment parse_concat()
+    {
+        auto fragment = empty();
+        while (m_pos < m_pattern.size() && m_pattern[m_pos] != '|' && m_pattern[m_pos] != ')')
+        {
+            fragment = concat(fragment, parse_repeat());
+        }
+        return fragment;
+    }
+
+    Fragment parse_repeat()
+    {
+        auto fragment = parse_atom();
+        while (m_pos < m_pattern.size())
+        {
+            switch (m_pattern[m_pos])
+            {
+            case '*':
+                fragment = star(fragment);
+                break;
+            case '+':
+                fragment = plus(fragment);
+                break;
+            case '?':
+                fragment = optional(fragment);
+                break;
+            default:
+                return fragment;
+            }
+            m_pos++;
+        }
+        return fragment;
+    }
+
+    Fragment parse_atom()
+    {
+        auto c = m_pattern[m_pos++];
+        std::bitset<ALPHABET> set;
+        switch (c)
+        {
+        case '(': {
+            auto fragment = parse_alternation();
+            if (m_pos == m_pattern.size() || m_pattern[m_pos] != ')')
+            {
+                m_error = true;
+                return fragment;
+            }
+            m_pos++;
+            return fragment;
+        }
+        case '.':
+            set.set();
+            break;
+        case '[':
+            m_error |= !parse_class(m_pattern, m_pos, set);
+            break;
+        case '*':
+        case '+':
+        case '?':
+            m_error = true;
+            return empty();
+        case '\\':
+            if (m_pos == m_pattern.size())
+            {
+                m_error = true;
+                return empty();
+            }
+            c = m_pattern[m_pos++];
+            return bytes(is_class_escape(c) ? escape_class(c) : single(c));
+        default:
+            return bytes(single(c));
+        }
+        return character(set);
+    }
+
+    /**
+     * Collects the longest run of bytes every match of the regex must contain.
+     * Only top level literals that are not made optional count and patterns with
+     * alternatives have none.
+     */
+    void regex_literal(std::string_view pattern)
+    {
+        if (pattern.find('|') != std::string_view::npos)
+        {
+            return;
+        }
+        size_t depth{0};
+        for (size_t pos = 0; pos < pattern.size();)
+        {
+            auto c = pattern[pos++];
+            bool literal{false};
+            if (c == '\\' && pos < pattern.size())
+            {
+                c = pattern[pos++];
+                literal = !is_class_escape(c);
+            }
+            else if (c == '[')
+            {
+                std::bitset<ALPHABET> set;
+                static_cast<void>(parse_class(pattern, pos, set));
+            }
+            else if (c == '(')
+            {
+                depth++;
+            }
+            else if (c == ')')
+            {
+                depth -= depth == 0 ? 0 : 1;
+            }
+            else
+            {
+                literal = std::string_view(".*+?").find(c) == std::string_view::npos;
+            }
+            auto next = pos < pattern.size() ? pattern[pos] : '\0';
+            if (literal && depth == 0 && next != '*' && next != '?')
+            {
+                m_run.push_back(c);
+            }
+            if (!literal || depth != 0 || next == '*' || next == '?' || next == '+')
+            {
+                commit();
+            }
+        }
+        commit();
+    }
+
+    /**
+     * Keeps the current literal run if it is the longest so far
+     */
+    void commit()
+    {
+        if (m_run.size() > m_literal.size())
+        {
+            m_literal = m_run;
+        }
+        m_run.clear();
+    }
+
+    /**
+     * Drops all cached DFA states
+     */
+    void flush()
+    {
+        std::fill(m_table.begin(), m_table.begin() + static_cast<std::ptrdiff_t>(m_states.size() * ALPHABET), UNKNOWN);
+        std::ranges::fill(m_buckets, UNKNOWN);
+        m_states.clear();
+        m_sets.clear();
+        m_starts[0] = UNKNOWN;
+        m_starts[1] = UNKNOWN;
+        m_flushes++;
+    }
+
+    /**
+     * Adds the BYTE and MATCH nodes reachable from index without consuming input to m_closure
+     */
+    void closure(int32_t index)
+    {
+        m_stack.push_back(index);
+        while (!m_stack.empty())
+        {
+            auto current = m_stack.back();
+            m_stack.pop_back();
+            if (current == UNKNOWN || m_marks[static_cast<size_t>(current)] == m_generation)
+            {
+                continue;
+            }
+            m_marks[static_cast<size_t>(current)] = m_generation;
+            const auto& current_node = at(current);
+            if (current_node.op == Op::SPLIT)
+            {
+                m_stack.push_back(current_node.alt);
+                m_stack.push_back(current_node.out);
+            }
+            else
+            {
+                m_closure.push_back(current);
+            }
+        }
+    }
+
+    /**
+     * Starts collecting a new m_closure
+     */
+    void begin_closure()
+    {
+        m_closure.clear();
+        if (++m_generation == 0)
+        {
+            std::ranges::fill(m_marks, 0);
+            m_generation = 1;
+        }
+    }
+
+    /**
+     * Looks up or creates the DFA state for m_closure
+     * @param search state also restarts the pattern at every byte
+     * @return int32_t state index
+     */
+    int32_t add_state(bool search)
+    {
+        std::ranges::sort(m_closure);
+        size_t hash{search ? 1U : 0U};
+        for (auto index : m_closure)
+        {
+            constexpr size_t PRIME{0x100000001B3};
+            hash = (hash ^ static_cast<size_t>(index)) * PRIME;
+        }
+        auto find = [&] {
+            auto bucket = hash % BUCKETS;
+            while (m_buckets[bucket] != UNKNOWN)
+            {
+                const auto& state = m_states[static_cast<size_t>(m_buckets[bucket])];
+                auto begin = m_sets.begin() + state.begin;
+                if (state.search == search && std::equal(begin, begin + state.size, m_closure.begin(), m_closure.end()))
+                {
+                    break;
+                }
+                bucket = (bucket + 1) % BUCKETS;
+            }
+            return bucket;
+        };
+        auto bucket = find();
+        if (m_buckets[bucket] != UNKNOWN)
+        {
+            return m_buckets[bucket];
+        }
+        if (m_states.size() == MAX_STATES)
+        {
+            flush();
+            bucket = find();
+        }
+        bool accept = std::ranges::any_of(m_closure, [this](int32_t index) { return at(index).op == Op::MATCH; });
+        m_states.push_back({.begin = static_cast<uint32_t>(m_sets.size()), .size = static_cast<uint32_t>(m_closure.size()), .accept = accept, .search = search});
+        m_sets.insert(m_sets.end(), m_closure.begin(), m_closure.end());
+        m_buckets[bucket] = static_cast<int32_t>(m_states.size() - 1);
+        return m_buckets[bucket];
+    }
+
+    /**
+     * @param search restart the pattern at every byte instead of only at the first
+     * @return int32_t initial DFA state
+     */
+    int32_t start(bool search)
+    {
+        auto& state = m_starts[search ? 1 : 0];
+        if (state == UNKNOWN)
+        {
+            begin_closure();
+            closure(m_start);
+            auto created = add_state(search);
+            state = created;
+        }
+        return state;
+    }
+
+    /**
+     * Follows the transition of state on byte, constructing the target state on first use
+     */
+    int32_t step(int32_t state, uint8_t byte)
+    {
+        auto cell = static_cast<size_t>(state) * ALPHABET + byte;
+        if (m_table[cell] != UNKNOWN)
+        {
+            return m_table[cell];
+        }
+        begin_closure();
+        const auto& current = m_states[static_cast<size_t>(state)];
+        for (auto index = current.begin; index < current.begin + current.size; index++)
+        {
+            const auto& set_node = at(m_sets[index]);
+            if (set_node.op == Op::BYTE && set_node.bytes[byte])
+            {
+                closure(set_node.out);
+            }
+        }
+        if (current.search)
+        {
+            closure(m_start);
+        }
+        auto flushes = m_flushes;
+        auto next = add_state(current.search);
+        if (flushes == m_flushes)
+        {
+            m_table[cell] = next;
+        }
+        return next;
+    }
+
+    /**
+     * Runs the anchored automaton from begin
+     * @return size_t end of the longest match starting at begin or npos
+     */
+    size_t longest(std::string_view path, size_t begin)
+    {
+        auto state = start(false);
+        auto accepts = [&](size_t end) { return m_states[static_cast<size_t>(state)].accept && (!m_end_anchor || end == path.size()); };
+        auto last = accepts(begin) ? begin : std::string_view::npos;
+        for (auto pos = begin; pos < path.size() && m_states[static_cast<size_t>(state)].size != 0; pos++)
+        {
+            state = step(state, static_cast<uint8_t>(path[pos]));
+            if (accepts(pos + 1))
+            {
+                last = pos + 1;
+            }
+        }
+        return last;
+    }
+
+    Syntax m_syntax;
+    bool m_error{false};
+    bool m_begin_anchor{false};
+    bool m_end_anchor{false};
+    std::string_view m_pattern;
+    size_t m_pos{0};
+    std::string m_literal;
+    std::string m_run;
+
+    std::vector<Node> m_nodes;
+    int32_t m_start{0};
+    std::vector<uint32_t> m_marks;
+    uint32_t m_generation{0};
+    std::vector<int32_t> m_stack;
+    std::vector<int32_t> m_closure;
+
+    std::vector<State> m_states;
+    std::vector<int32_t> m_sets;
+    std::vector<int32_t> m_table;
+    std::vector<int32_t> m_buckets;
+    int32_t m_starts[2]{UNKNOWN, UNKNOWN}; /// NOLINT
+    size_t m_flushes{0};
+};
+} // namespace pattern
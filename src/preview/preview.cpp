@@ -0,0 +1,261 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+export module preview;
+
+namespace fs = std::filesystem;
+
+namespace preview
+{
+/**
+ * Alphabetically first names of the entries in a directory, directories end with '/'.
+ * Directories with more than Prefetcher::MAX_ENTRIES entries get a last line counting the rest.
+ */
+export using Listing = std::vector<std::string>;
+
+/**
+ * Lists directories on a background thread and keeps the most recently used listings cached.
+ * Requests and lookups take folders relative to the root and don't allocate for
+ * folders up to PATH_CAPACITY bytes, so they can be made while drawing a frame.
+ */
+export class Prefetcher
+{
+  public:
+    /**
+     * Max number of entries listed of a single directory
+     */
+    static constexpr size_t MAX_ENTRIES{256};
+
+    /**
+     * Max number of folders in a single request
+     */
+    static constexpr size_t MAX_REQUESTS{3};
+
+    /**
+     * Length of a requested folder that can be queued without allocating
+     */
+    static constexpr size_t PATH_CAPACITY{4096};
+
+    /**
+     * @param root directory requested folders are relative to
+     * @param on_ready called from the prefetch thread with the folder whose listing has been cached
+     * @param capacity max number of cached listings
+     */
+    Prefetcher(fs::path root, std::function<void(std::string_view)> on_ready, size_t capacity = 64)
+        : m_root(std::move(root)), m_on_ready(std::move(on_ready)), m_capacity(capacity)
+    {
+        for (auto& folder : m_pending)
+        {
+            folder.reserve(PATH_CAPACITY);
+        }
+        m_thread = std::jthread([this](const std::stop_token& stop_token) { run(stop_token); });
+    }
+
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+    Prefetcher(Prefetcher&&) = delete;
+    Prefetcher& operator=(Prefetcher&&) = delete;
+
+    ~Prefetcher()
+    {
+        m_thread.request_stop();
+        m_thread.join();
+    }
+
+    /**
+     * Retrieves a cached listing without blocking on I/O
+     * @param folder directory to look up, relative to root
+     * @return listing or nullptr if folder has not been fetched yet
+     */
+    [[nodiscard]] std::shared_ptr<const Listing> get(std::string_view folder)
+    {
+        std::scoped_lock lock(m_mutex);
+        auto iter = m_cache.find(folder);
+        if (iter == m_cache.end())
+        {
+            return nullptr;
+        }
+        m_lru.splice(m_lru.begin(), m_lru, iter->second);
+        return iter->second->second;
+    }
+
+    /**
+     * Replaces all pending requests with folders, in priority order.
+     * Requests not part of folders are cancelled, including one being read.
+     * @param folders directories to prefetch relative to root, only the first MAX_REQUESTS are used
+     */
+    void request(std::span<const std::string_view> folders)
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_pending_count = 0;
+            for (auto folder : folders.first(std::min(folders.size(), MAX_REQUESTS)))
+            {
+                if (!m_cache.contains(folder))
+                {
+                    m_pending[m_pending_count++].assign(folder);
+                }
+            }
+            m_generation++;
+        }
+        m_wakeup.notify_one();
+    }
+
+  private:
+    /**
+     * Hash of folder names that also looks up std::string_view keys
+     */
+    struct Hash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view folder) const
+        {
+            return std::hash<std::string_view>{}(folder);
+        }
+    };
+
+    void run(const std::stop_token& stop_token)
+    {
+        while (true)
+        {
+            std::string folder;
+            uint64_t generation{0};
+            {
+                std::unique_lock lock(m_mutex);
+                if (!m_wakeup.wait(lock, stop_token, [this] { return m_pending_count != 0; }))
+                {
+                    return;
+                }
+                folder = m_pending.front();
+                remove(0);
+                generation = m_generation;
+            }
+
+            auto listing = std::make_shared<Listing>();
+            if (!read(folder, generation, *listing))
+            {
+                continue;
+            }
+            insert(folder, std::move(listing));
+            m_on_ready(folder);
+        }
+    }
+
+    /**
+     * Reads the alphabetically first MAX_ENTRIES entries of folder into listing,
+     * keeping them in a max heap so that large directories are never held in full
+     * @return bool false if the request went stale while reading
+     */
+    bool read(const std::string& folder, uint64_t generation, Listing& listing)
+    {
+        size_t entries{0};
+        std::error_code error;
+        for (auto iter = fs::directory_iterator(m_root / folder, fs::directory_options::skip_permission_denied, error); !error && iter != fs::directory_iterator(); iter.increment(error))
+        {
+            if (stale(folder, generation))
+            {
+                return false;
+            }
+            entries++;
+            // Entries that fail to stat are listed as files rather than ending the listing
+            std::error_code entry_error;
+            listing.push_back(iter->path().filename().string() + (iter->is_directory(entry_error) ? "/" : ""));
+            std::ranges::push_heap(listing);
+            if (listing.size() > MAX_ENTRIES)
+            {
+                std::ranges::pop_heap(listing);
+                listing.pop_back();
+            }
+        }
+        std::ranges::sort_heap(listing);
+        if (entries > listing.size())
+        {
+            listing.push_back("... " + std::to_string(entries - listing.size()) + " more");
+        }
+        return true;
+    }
+
+    /**
+     * Checks if the request for folder was cancelled by a newer request
+     */
+    bool stale(std::string_view folder, uint64_t generation)
+    {
+        std::scoped_lock lock(m_mutex);
+        return generation != m_generation && pending(folder) == m_pending_count;
+    }
+
+    /**
+     * @return size_t index of folder in m_pending, m_pending_count if it is not pending
+     */
+    [[nodiscard]] size_t pending(std::string_view folder) const
+    {
+        return static_cast<size_t>(std::find(m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>(m_pending_count), folder) - m_pending.begin());
+    }
+
+    /**
+     * Removes the pending request at index, keeping the buffers of all requests
+     */
+    void remove(size_t index)
+    {
+        auto begin = m_pending.begin() + static_cast<std::ptrdiff_t>(index);
+        std::rotate(begin, begin + 1, m_pending.begin() + static_cast<std::ptrdiff_t>(m_pending_count));
+        m_pending_count--;
+    }
+
+    void insert(const std::string& folder, std::shared_ptr<const Listing> listing)
+    {
+        std::scoped_lock lock(m_mutex);
+        if (auto index = pending(folder); index != m_pending_count)
+        {
+            remove(index);
+        }
+        if (m_cache.contains(folder))
+        {
+            return;
+        }
+        m_lru.emplace_front(folder, std::move(listing));
+        m_cache.emplace(folder, m_lru.begin());
+        if (m_lru.size() > m_capacity)
+        {
+            m_cache.erase(m_lru.back().first);
+            m_lru.pop_back();
+        }
+    }
+
+    using Entry = std::pair<std::string, std::shared_ptr<const Listing>>;
+
+    fs::path m_root;
+    std::function<void(std::string_view)> m_on_ready;
+    size_t m_capacity;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_wakeup;
+    std::array<std::string, MAX_REQUESTS> m_pending;
+    size_t m_pending_count{0};
+    uint64_t m_generation{0};
+    std::list<Entry> m_lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator, Hash, std::equal_to<>> m_cache;
+
+    std::jthread m_thread;
+};
+} // namespace preview
@@ -0,0 +1,346 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module query;
+import unicode;
+
+namespace query
+{
+/**
+ * How a term is matched against a path
+ */
+export enum class Kind : uint8_t
+{
+    FUZZY,  // UTF-8 characters appear in order (text)
+    EXACT,  // Substring ('text)
+    PREFIX, // Path starts with text (^text)
+    SUFFIX, // Path ends with text (text$)
+    EQUAL,  // Path is text (^text$)
+};
+
+/**
+ * Single space separated term of a query
+ */
+export struct Term
+{
+    Kind kind{Kind::FUZZY};
+    bool negate{false};
+    std::string_view text;
+};
+
+/**
+ * Parsed fzf style extended query.
+ * Space separated terms must all match, terms joined by | match if either does.
+ * Clauses are ordered so that cheap and selective checks reject paths first:
+ * anchored terms, then substrings, then negations and fuzzy terms last.
+ * Matches are only filtered, not scored, and keep the order of the folders.
+ */
+export class Plan
+{
+  public:
+    /**
+     * Makes room for the terms and clauses of any search up to length bytes,
+     * so that parsing it does not allocate
+     * @param length max length of a parsed search
+     */
+    void reserve(size_t length)
+    {
+        // Every term takes at least one byte and a separating space
+        m_text.reserve(length);
+        m_terms.reserve(length / 2 + 1);
+        m_clauses.reserve(length / 2 + 1);
+    }
+
+    /**
+     * Replaces the plan with one for search
+     * @param search extended query string
+     */
+    void parse(std::string_view search)
+    {
+        m_text.assign(search);
+        m_terms.clear();
+        m_clauses.clear();
+
+        bool join{false};
+        std::string_view rest(m_text);
+        while (!rest.empty())
+        {
+            auto token = rest.substr(0, rest.find(' '));
+            rest.remove_prefix(std::min(rest.size(), token.size() + 1));
+            if (token == "|")
+            {
+                join = !m_clauses.empty();
+                continue;
+            }
+            auto term = parse_term(token);
+            if (term.text.empty())
+            {
+                continue;
+            }
+            if (join)
+            {
+                m_clauses.back().end++;
+            }
+            else
+            {
+                m_clauses.push_back({.begin = m_terms.size(), .end = m_terms.size() + 1});
+            }
+            m_terms.push_back(term);
+            join = false;
+        }
+
+        for (auto& clause : m_clauses)
+        {
+            for (auto term = clause.begin; term < clause.end; term++)
+            {
+                clause.cost = std::max(clause.cost, cost(m_terms[term]));
+                clause.length = std::max(clause.length, m_terms[term].text.size());
+            }
+        }
+        // Insertion sort keeps clauses stable without the temporary buffer of std::stable_sort
+        for (auto clause = m_clauses.begin(); clause != m_clauses.end(); clause++)
+        {
+            std::rotate(std::upper_bound(m_clauses.begin(), clause, *clause, before), clause, clause + 1);
+        }
+    }
+
+    /**
+     * @return bool true if every path matches
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return m_clauses.empty();
+    }
+
+    /**
+     * Checks path against all clauses without computing match positions
+     * @param path candidate path
+     */
+    [[nodiscard]] bool matches(std::string_view path) const
+    {
+        for (const auto& clause : m_clauses)
+        {
+            bool any{false};
+            for (auto term = clause.begin; term < clause.end && !any; term++)
+            {
+                any = matches(m_terms[term], path);
+            }
+            if (!any)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Retrieves the longest text every match must contain, usable for index lookups.
+     * Fuzzy terms never provide one since none of their characters have to be adjacent.
+     * @return std::string_view literal or empty if no term requires one
+     */
+    [[nodiscard]] std::string_view literal() const
+    {
+        std::string_view literal;
+        for (const auto& clause : m_clauses)
+        {
+            const auto& term = m_terms[clause.begin];
+            if (clause.end - clause.begin == 1 && !term.negate && term.kind != Kind::FUZZY && term.text.size() > literal.size())
+            {
+                literal = term.text;
+            }
+        }
+        return literal;
+    }
+
+    /**
+     * Calls func(terms) for every clause in the order clauses are evaluated
+     * @param func callback taking the std::span<const Term> alternatives of a clause
+     */
+    void for_each_clause(auto&& func) const
+    {
+        for (const auto& clause : m_clauses)
+        {
+            func(std::span<const Term>(m_terms).subspan(clause.begin, clause.end - clause.begin));
+        }
+    }
+
+    /**
+     * Appends the sorted, non overlapping ranges of path matched by the plan
+     * @param path matching path
+     * @param spans container of structs with begin and length members
+     */
+    void highlight(std::string_view path, auto& spans) const
+    {
+        auto first = spans.size();
+        for (const auto& clause : m_clauses)
+        {
+            for (auto term = clause.begin; term < clause.end; term++)
+            {
+                if (!m_terms[term].negate && matches(m_terms[term], path))
+                {
+                    positions(m_terms[term], path, spans);
+                    break;
+                }
+            }
+        }
+
+        auto begin = spans.begin() + static_cast<std::ptrdiff_t>(first);
+        std::sort(begin, spans.end(), [](const auto& lhs, const auto& rhs) { return lhs.begin < rhs.begin; });
+        auto merged = begin;
+        for (auto span = begin; span != spans.end(); span++)
+        {
+            if (span != begin && span->begin <= merged->begin + merged->length)
+            {
+                merged->length = std::max(merged->begin + merged->length, span->begin + span->length) - merged->begin;
+            }
+            else if (span != begin)
+            {
+                *++merged = *span;
+            }
+        }
+        if (begin != spans.end())
+        {
+            spans.erase(merged + 1, spans.end());
+        }
+    }
+
+  private:
+    /**
+     * Range of alternative terms in m_terms, ordered by cost
+     */
+    struct Clause
+    {
+        size_t begin{0};
+        size_t end{0};
+        int cost{0};
+        size_t length{0};
+    };
+
+    static bool before(const Clause& lhs, const Clause& rhs)
+    {
+        return lhs.cost != rhs.cost ? lhs.cost < rhs.cost : lhs.length > rhs.length;
+    }
+
+    static Term parse_term(std::string_view token)
+    {
+        Term term;
+        if (token.starts_with('!'))
+        {
+            term.negate = true;
+            term.kind = Kind::EXACT;
+            token.remove_prefix(1);
+        }
+        if (token.starts_with('\''))
+        {
+            term.kind = Kind::EXACT;
+            token.remove_prefix(1);
+        }
+        else if (token.starts_with('^'))
+        {
+            term.kind = Kind::PREFIX;
+            token.remove_prefix(1);
+        }
+        if (token.size() > 1 && token.ends_with('$'))
+        {
+            term.kind = term.kind == Kind::PREFIX ? Kind::EQUAL : Kind::SUFFIX;
+            token.remove_suffix(1);
+        }
+        term.text = token;
+        return term;
+    }
+
+    /**
+     * Relative cost of evaluating term, lower runs first
+     */
+    static int cost(const Term& term)
+    {
+        if (term.kind == Kind::FUZZY)
+        {
+            return 3;
+        }
+        if (term.negate)
+        {
+            return 2;
+        }
+        return term.kind == Kind::EXACT ? 1 : 0;
+    }
+
+    static bool matches(const Term& term, std::string_view path)
+    {
+        bool match{false};
+        switch (term.kind)
+        {
+        case Kind::FUZZY: {
+            size_t pos{0};
+            match = true;
+            for (size_t index = 0; index < term.text.size();)
+            {
+                auto character = term.text.substr(index, unicode::length(term.text[index]));
+                pos = path.find(character, pos);
+                if (pos == std::string_view::npos)
+                {
+                    match = false;
+                    break;
+                }
+                pos += character.size();
+                index += character.size();
+            }
+            break;
+        }
+        case Kind::EXACT:
+            match = path.find(term.text) != std::string_view::npos;
+            break;
+        case Kind::PREFIX:
+            match = path.starts_with(term.text);
+            break;
+        case Kind::SUFFIX:
+            match = path.ends_with(term.text);
+            break;
+        case Kind::EQUAL:
+            match = path == term.text;
+            break;
+        }
+        return match != term.negate;
+    }
+
+    static void positions(const Term& term, std::string_view path, auto& spans)
+    {
+        switch (term.kind)
+        {
+        case Kind::FUZZY: {
+            size_t pos{0};
+            for (size_t index = 0; index < term.text.size();)
+            {
+                auto character = term.text.substr(index, unicode::length(term.text[index]));
+                pos = path.find(character, pos);
+                spans.push_back({.begin = pos, .length = character.size()});
+                pos += character.size();
+                index += character.size();
+            }
+            break;
+        }
+        case Kind::EXACT:
+            spans.push_back({.begin = path.find(term.text), .length = term.text.size()});
+            break;
+        case Kind::PREFIX:
+        case Kind::EQUAL:
+            spans.push_back({.begin = 0, .length = term.text.size()});
+            break;
+        case Kind::SUFFIX:
+            spans.push_back({.begin = path.size() - term.text.size(), .length = term.text.size()});
+            break;
+        }
+    }
+
+    std::string m_text;
+    std::vector<Term> m_terms;
+    std::vector<Clause> m_clauses;
+};
+} // namespace query
@@ -0,0 +1,188 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+export module radix;
+
+namespace
+{
+/**
+ * One bucket for keys that end at the current depth and one per byte value
+ */
+constexpr size_t DIGITS{257};
+
+/**
+ * Ranges smaller than this are sorted by comparison instead of bucketed
+ */
+constexpr size_t INSERTION_CUTOFF{32};
+
+/**
+ * Ranges at least this large are handed to other threads instead of sorted in place
+ */
+constexpr size_t PARALLEL_CUTOFF{1U << 14U};
+
+/**
+ * Range of ids whose keys share their first depth bytes
+ */
+struct Task
+{
+    size_t begin;
+    size_t end;
+    size_t depth;
+};
+
+/**
+ * Parallel most significant digit radix sort of ids by their keys.
+ * Every range is bucketed by the byte at its depth, buckets are then sorted by
+ * the next byte. Large buckets go to a shared queue so that idle threads pick
+ * them up, small ones are sorted by the thread that produced them.
+ */
+class Sorter
+{
+  public:
+    Sorter(std::span<const std::string_view> keys, std::vector<uint32_t>& ids) : m_keys(keys), m_ids(ids), m_scratch(ids.size()), m_buckets(ids.size())
+    {
+    }
+
+    void run(size_t threads)
+    {
+        m_queue.push_back({.begin = 0, .end = m_ids.size(), .depth = 0});
+        std::vector<std::jthread> workers;
+        for (size_t thread = 1; thread < threads && m_ids.size() >= PARALLEL_CUTOFF; thread++)
+        {
+            workers.emplace_back([this] { work(); });
+        }
+        work();
+    }
+
+  private:
+    [[nodiscard]] static size_t bucket(std::string_view key, size_t depth)
+    {
+        return depth < key.size() ? static_cast<size_t>(static_cast<uint8_t>(key[depth])) + 1 : 0;
+    }
+
+    /**
+     * Takes tasks from the queue until it is empty and no thread can add more
+     */
+    void work()
+    {
+        std::vector<Task> stack;
+        while (true)
+        {
+            {
+                std::unique_lock lock(m_mutex);
+                m_ready.wait(lock, [this] { return !m_queue.empty() || m_active == 0; });
+                if (m_queue.empty())
+                {
+                    return;
+                }
+                stack.push_back(m_queue.back());
+                m_queue.pop_back();
+                m_active++;
+            }
+            while (!stack.empty())
+            {
+                auto task = stack.back();
+                stack.pop_back();
+                sort(task, stack);
+            }
+            std::scoped_lock lock(m_mutex);
+            if (--m_active == 0 && m_queue.empty())
+            {
+                m_ready.notify_all();
+            }
+        }
+    }
+
+    /**
+     * Buckets task by the byte at its depth and schedules every bucket with more than one key
+     * @param task range to sort
+     * @param stack tasks of the current thread
+     */
+    void sort(const Task& task, std::vector<Task>& stack)
+    {
+        auto ids = std::span(m_ids).subspan(task.begin, task.end - task.begin);
+        if (ids.size() < INSERTION_CUTOFF)
+        {
+            std::sort(ids.begin(), ids.end(), [this, &task](uint32_t lhs, uint32_t rhs) {
+                auto left = m_keys[lhs];
+                auto right = m_keys[rhs];
+                return left.substr(std::min(task.depth, left.size())) < right.substr(std::min(task.depth, right.size()));
+            });
+            return;
+        }
+
+        std::array<size_t, DIGITS + 1> offsets{};
+        for (size_t index = 0; index < ids.size(); index++)
+        {
+            auto value = static_cast<uint16_t>(bucket(m_keys[ids[index]], task.depth));
+            m_buckets[task.begin + index] = value;
+            offsets[value + 1]++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        auto next = offsets;
+        for (size_t index = 0; index < ids.size(); index++)
+        {
+            m_scratch[task.begin + next[m_buckets[task.begin + index]]++] = ids[index];
+        }
+        std::copy_n(m_scratch.begin() + static_cast<std::ptrdiff_t>(task.begin), ids.size(), ids.begin());
+
+        // Keys in the first bucket ended at this depth and are equal
+        for (size_t value = 1; value < DIGITS; value++)
+        {
+            Task bucket_task{.begin = task.begin + offsets[value], .end = task.begin + offsets[value + 1], .depth = task.depth + 1};
+            if (bucket_task.end - bucket_task.begin < 2)
+            {
+                continue;
+            }
+            if (bucket_task.end - bucket_task.begin >= PARALLEL_CUTOFF)
+            {
+                std::scoped_lock lock(m_mutex);
+                m_queue.push_back(bucket_task);
+                m_ready.notify_one();
+            }
+            else
+            {
+                stack.push_back(bucket_task);
+            }
+        }
+    }
+
+    std::span<const std::string_view> m_keys;
+    std::vector<uint32_t>& m_ids;
+    std::vector<uint32_t> m_scratch;
+    std::vector<uint16_t> m_buckets;
+
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::vector<Task> m_queue;
+    size_t m_active{0};
+};
+} // namespace
+
+namespace radix
+{
+/**
+ * Computes the lexicographic byte order of keys with a parallel MSD radix sort
+ * @param keys strings to order, equal to the order of a std::set<std::string>
+ * @param threads number of threads to sort with, including the calling thread
+ * @return std::vector<uint32_t> indices into keys in sorted order
+ */
+export [[nodiscard]] std::vector<uint32_t> sort(std::span<const std::string_view> keys, size_t threads = std::max(1U, std::thread::hardware_concurrency()))
+{
+    std::vector<uint32_t> ids(keys.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    Sorter(keys, ids).run(threads);
+    return ids;
+}
+} // namespace radix
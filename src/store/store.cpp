@@ -0,0 +1,216 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module store;
+import varint;
+
+namespace
+{
+/**
+ * Number of paths per front coded block, the first path of each block is stored in full
+ */
+constexpr uint32_t BLOCK_SIZE{16};
+} // namespace
+
+namespace store
+{
+/**
+ * Storage for candidate paths, either as plain strings or front coded.
+ * In compact mode sorted paths are stored in blocks where every path but the
+ * first is encoded as the length of the prefix shared with the previous path
+ * followed by the remaining suffix. Blocks are decoded on the fly when scanned.
+ */
+export class Store
+{
+  public:
+    /**
+     * @param compact front code paths instead of storing them in full
+     */
+    explicit Store(bool compact = false) : m_compact(compact)
+    {
+    }
+
+    /**
+     * Appends path, paths should be pushed in sorted order for best compression
+     * @param path path to store
+     */
+    void push_back(std::string_view path)
+    {
+        m_max_length = std::max(m_max_length, path.size());
+        if (!m_compact)
+        {
+            m_paths.emplace_back(path);
+            return;
+        }
+        size_t shared{0};
+        if (m_size % BLOCK_SIZE == 0)
+        {
+            m_restarts.push_back(static_cast<uint32_t>(m_data.size()));
+        }
+        else
+        {
+            auto max_shared = std::min(path.size(), m_last.size());
+            while (shared < max_shared && path[shared] == m_last[shared])
+            {
+                shared++;
+            }
+        }
+        varint::put(m_data, shared);
+        varint::put(m_data, path.size() - shared);
+        m_data.insert(m_data.end(), path.begin() + static_cast<std::ptrdiff_t>(shared), path.end());
+        m_last.assign(path);
+        m_size++;
+    }
+
+    /**
+     * Releases memory only needed while pushing paths
+     */
+    void finalize()
+    {
+        m_paths.shrink_to_fit();
+        m_data.shrink_to_fit();
+        m_restarts.shrink_to_fit();
+        m_last = std::string();
+        m_scratch.reserve(m_max_length);
+    }
+
+    /**
+     * @return size_t number of stored paths
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return m_compact ? m_size : m_paths.size();
+    }
+
+    /**
+     * @return size_t length of the longest stored path
+     */
+    [[nodiscard]] size_t max_length() const
+    {
+        return m_max_length;
+    }
+
+    /**
+     * Retrieves path with id
+     * @param id index of path
+     * @param buffer storage for the decoded path in compact mode
+     * @return std::string_view path, valid until buffer or the store changes
+     */
+    [[nodiscard]] std::string_view get(uint32_t id, std::string& buffer) const
+    {
+        if (!m_compact)
+        {
+            return m_paths[id];
+        }
+        const auto* data = m_data.data() + m_restarts[id / BLOCK_SIZE];
+        for (uint32_t index = id - id % BLOCK_SIZE; index <= id; index++)
+        {
+            decode(data, buffer);
+        }
+        return buffer;
+    }
+
+    /**
+     * Calls func(id, path) for every stored path in order
+     * @param func callback taking uint32_t and std::string_view
+     */
+    void for_each(auto&& func) const
+    {
+        if (!m_compact)
+        {
+            for (uint32_t id = 0; id < m_paths.size(); id++)
+            {
+                func(id, std::string_view(m_paths[id]));
+            }
+            return;
+        }
+        const auto* data = m_data.data();
+        for (uint32_t id = 0; id < m_size; id++)
+        {
+            decode(data, m_scratch);
+            func(id, std::string_view(m_scratch));
+        }
+    }
+
+    /**
+     * Calls func(id, path) for every id in ids, decoding each block at most once
+     * @param ids sorted ids of paths to visit
+     * @param func callback taking uint32_t and std::string_view
+     */
+    void for_each(const std::vector<uint32_t>& ids, auto&& func) const
+    {
+        if (!m_compact)
+        {
+            for (auto id : ids)
+            {
+                func(id, std::string_view(m_paths[id]));
+            }
+            return;
+        }
+        const char* data{nullptr};
+        uint32_t next{0};
+        for (auto id : ids)
+        {
+            if (data == nullptr || id < next || id / BLOCK_SIZE != (next - 1) / BLOCK_SIZE)
+            {
+                next = id - id % BLOCK_SIZE;
+                data = m_data.data() + m_restarts[id / BLOCK_SIZE];
+            }
+            for (; next <= id; next++)
+            {
+                decode(data, m_scratch);
+            }
+            func(id, std::string_view(m_scratch));
+        }
+    }
+
+    /**
+     * @return size_t bytes used to store all paths
+     */
+    [[nodiscard]] size_t bytes() const
+    {
+        if (!m_compact)
+        {
+            size_t total{m_paths.capacity() * sizeof(std::string)};
+            for (const auto& path : m_paths)
+            {
+                if (path.capacity() > std::string().capacity())
+                {
+                    total += path.capacity() + 1;
+                }
+            }
+            return total;
+        }
+        return m_data.capacity() + m_restarts.capacity() * sizeof(uint32_t);
+    }
+
+  private:
+    /**
+     * Decodes the entry at data on top of the previous path in path
+     */
+    static void decode(const char*& data, std::string& path)
+    {
+        auto shared = varint::get<size_t>(data);
+        auto suffix = varint::get<size_t>(data);
+        path.resize(shared);
+        path.append(data, suffix);
+        data += suffix;
+    }
+
+    bool m_compact;
+    size_t m_max_length{0};
+    std::vector<std::string> m_paths;
+
+    uint32_t m_size{0};
+    std::vector<char> m_data;
+    std::vector<uint32_t> m_restarts;
+    std::string m_last;
+    mutable std::string m_scratch;
+};
+} // namespace store
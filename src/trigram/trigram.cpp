@@ -0,0 +1,187 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+export module trigram;
+import varint;
+
+namespace
+{
+/**
+ * Packs three bytes into a trigram key
+ * @param str string with at least three bytes
+ */
+[[nodiscard]] uint32_t pack(std::string_view str)
+{
+    return static_cast<uint32_t>(static_cast<uint8_t>(str[0])) << 16U | static_cast<uint32_t>(static_cast<uint8_t>(str[1])) << 8U | static_cast<uint32_t>(static_cast<uint8_t>(str[2]));
+}
+} // namespace
+
+namespace trigram
+{
+/**
+ * Length of the shortest literal that can be looked up in the index
+ */
+export constexpr size_t MIN_QUERY{3};
+
+/**
+ * Inverted index from byte trigrams to the ids of the paths containing them.
+ * Posting lists are stored as delta encoded varints so that memory stays
+ * proportional to the number of distinct trigrams per path.
+ */
+export class Index
+{
+  public:
+    /**
+     * Adds path to the index, ids must be added in increasing order
+     * @param id candidate id of path
+     * @param path path to extract trigrams from
+     */
+    void add(uint32_t id, std::string_view path)
+    {
+        for (size_t pos = 0; pos + MIN_QUERY <= path.size(); pos++)
+        {
+            auto& posting = m_postings[pack(path.substr(pos))];
+            if (posting.count != 0 && posting.last == id)
+            {
+                continue;
+            }
+            varint::put(posting.data, posting.count == 0 ? id : id - posting.last);
+            posting.last = id;
+            posting.count++;
+        }
+    }
+
+    /**
+     * Releases slack capacity once all paths have been added
+     */
+    void finalize()
+    {
+        for (auto& [key, posting] : m_postings)
+        {
+            posting.data.shrink_to_fit();
+        }
+        m_lists.reserve(MAX_LISTS);
+    }
+
+    /**
+     * Retrieves ids of all paths containing every trigram of literal.
+     * The result is a superset of the paths containing literal and has to be verified.
+     * At most MAX_LISTS distinct trigrams are intersected, the rarest ones, which keeps
+     * the result a superset for literals of any length without allocating.
+     * @param literal search string, literals shorter than MIN_QUERY bytes give no candidates
+     * @param out sorted candidate ids, cleared before use
+     */
+    void query(std::string_view literal, std::vector<uint32_t>& out) const
+    {
+        out.clear();
+        m_lists.clear();
+        for (size_t pos = 0; pos + MIN_QUERY <= literal.size(); pos++)
+        {
+            auto iter = m_postings.find(pack(literal.substr(pos)));
+            if (iter == m_postings.end())
+            {
+                return;
+            }
+            if (std::ranges::find(m_lists, &iter->second) != m_lists.end())
+            {
+                continue;
+            }
+            if (m_lists.size() < MAX_LISTS)
+            {
+                m_lists.push_back(&iter->second);
+                continue;
+            }
+            auto common = std::ranges::max_element(m_lists, {}, &Posting::count);
+            if (iter->second.count < (*common)->count)
+            {
+                *common = &iter->second;
+            }
+        }
+        if (m_lists.empty())
+        {
+            return;
+        }
+        std::ranges::sort(m_lists, {}, &Posting::count);
+
+        decode(*m_lists.front(), out);
+        for (auto list = m_lists.begin() + 1; list != m_lists.end() && !out.empty(); list++)
+        {
+            intersect(**list, out);
+        }
+    }
+
+    /**
+     * @return size_t bytes used by the encoded posting lists
+     */
+    [[nodiscard]] size_t bytes() const
+    {
+        size_t total{0};
+        for (const auto& [key, posting] : m_postings)
+        {
+            total += posting.data.capacity() + sizeof(key) + sizeof(posting);
+        }
+        return total;
+    }
+
+  private:
+    /**
+     * Posting lists a query intersects at most, further trigrams rarely narrow the candidates
+     */
+    static constexpr size_t MAX_LISTS{64};
+
+    struct Posting
+    {
+        std::vector<uint8_t> data;
+        uint32_t last{0};
+        uint32_t count{0};
+    };
+
+    static void decode(const Posting& posting, std::vector<uint32_t>& out)
+    {
+        const auto* data = posting.data.data();
+        uint32_t id{0};
+        for (uint32_t i = 0; i < posting.count; i++)
+        {
+            id += varint::get<uint32_t>(data);
+            out.push_back(id);
+        }
+    }
+
+    /**
+     * Keeps only the ids in out that are also present in posting
+     */
+    static void intersect(const Posting& posting, std::vector<uint32_t>& out)
+    {
+        const auto* data = posting.data.data();
+        uint32_t id{0};
+        uint32_t decoded{0};
+        size_t kept{0};
+        for (auto candidate : out)
+        {
+            while ((decoded == 0 || id < candidate) && decoded < posting.count)
+            {
+                id += varint::get<uint32_t>(data);
+                decoded++;
+            }
+            if (decoded != 0 && id == candidate)
+            {
+                out[kept++] = candidate;
+            }
+            else if (id < candidate)
+            {
+                break;
+            }
+        }
+        out.resize(kept);
+    }
+
+    std::unordered_map<uint32_t, Posting> m_postings;
+    mutable std::vector<const Posting*> m_lists;
+};
+} // namespace trigram
@@ -1,17 +1,67 @@
 module;
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <clocale>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <curses.h>
+#include <filesystem>
+#include <fstream>
 #include <mutex>
-#include <set>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <termios.h>
+#include <vector>
 
 export module tui;
+import preview;
+import unicode;
+
+namespace fs = std::filesystem;
 
 namespace tui
 {
 constexpr int WINPUT_HEIGHT{1};
+constexpr int WPREVIEW_PERCENT{40};
+
+/**
+ * Range of highlighted characters in a row
+ */
+export struct Span
+{
+    size_t begin{0};
+    size_t length{0};
+};
+
+/**
+ * Folding of a folder in the tree view
+ */
+export enum class Branch : uint8_t
+{
+    LEAF,      // No subfolder matches
+    COLLAPSED, // Matching subfolders are hidden
+    EXPANDED,  // Matching subfolders follow
+};
+
+/**
+ * Visible match with the characters to highlight, spans are sorted and non overlapping.
+ * The tree view draws the last folder of text below depth parents, flat views ignore
+ * depth, count and branch.
+ */
+export struct Row
+{
+    std::string_view text;
+    std::span<const Span> spans;
+    bool nested{false};          // Drawn as the last folder of text below its parents
+    size_t depth{0};             // Parents of the folder
+    size_t count{0};             // Matching subfolders at any depth
+    Branch branch{Branch::LEAF}; // Folding of the folder
+};
 
 class Impl
 {
@@ -24,10 +74,16 @@ class Impl
 
     void draw_input(const std::string& input);
 
-    void draw_matches(size_t index, const std::set<std::string>& matches, size_t total_folders);
+    void draw_matches(size_t index, const std::vector<Row>& rows, size_t matches, size_t total_folders);
+
+    [[nodiscard]] size_t rows() const;
 
     [[nodiscard]] int get_input() const;
 
+    void enable_preview(const fs::path& root);
+
+    void record(const fs::path& file);
+
   private:
     struct Pos
     {
@@ -35,10 +91,25 @@ class Impl
         int x{0};
     };
 
+    void draw_row(const Row& row);
+
+    void draw_clipped(std::string_view text);
+
+    void draw_preview();
+
     Pos m_winput_pos;
     WINDOW* m_winput_p;
     WINDOW* m_wresults_p;
+    WINDOW* m_wpreview_p{nullptr};
     std::mutex m_term_mutex;
+
+    std::string m_preview_path;
+    std::array<std::string_view, preview::Prefetcher::MAX_REQUESTS> m_prefetch;
+
+    mutable std::ofstream m_record;
+    mutable std::chrono::steady_clock::time_point m_last_input;
+
+    std::optional<preview::Prefetcher> m_prefetcher;
 };
 
 /**
@@ -78,12 +149,42 @@ class Tui
 
     /**
      * Draws the matching folders
-     * @param matches vector with all folder names
+     * @param index selected row in rows
+     * @param rows visible matching folder names, at most rows() of them
+     * @param matches total amount of matching folders
      * @param total_folders total amount of folders in search dir
      */
-    void draw_matches(size_t index, const std::set<std::string>& matches, size_t total_folders)
+    void draw_matches(size_t index, const std::vector<Row>& rows, size_t matches, size_t total_folders)
     {
-        m_impl.draw_matches(index, matches, total_folders);
+        m_impl.draw_matches(index, rows, matches, total_folders);
+    }
+
+    /**
+     * Retrieves how many matches fit in the results window
+     * @return size_t amount of visible rows
+     */
+    [[nodiscard]] size_t rows() const
+    {
+        return m_impl.rows();
+    }
+
+    /**
+     * Splits off a pane listing the contents of the selected folder
+     * @param root directory the drawn matches are relative to
+     */
+    void enable_preview(const fs::path& root)
+    {
+        m_impl.enable_preview(root);
+    }
+
+    /**
+     * Records every key read by get_input together with the time since the previous key.
+     * Each line of file holds "<microseconds> <key>", lines starting with # are comments.
+     * @param file session file to write
+     */
+    void record(const fs::path& file)
+    {
+        m_impl.record(file);
     }
 
     /**
@@ -113,35 +214,37 @@ void Impl::draw_input(const std::string& input)
     m_term_mutex.lock();
     wmove(m_winput_p, 0, 0);
     wclrtoeol(m_winput_p);
-    wprintw(m_winput_p, "> ");
-    wprintw(m_winput_p, "%s", input.c_str());
+    waddstr(m_winput_p, "> ");
+    waddnstr(m_winput_p, input.data(), static_cast<int>(input.size()));
     getyx(m_winput_p, m_winput_pos.y, m_winput_pos.x);
     wrefresh(m_winput_p);
     m_term_mutex.unlock();
 }
 
-void Impl::draw_matches(size_t index, const std::set<std::string>& matches, size_t total_folders)
+void Impl::draw_matches(size_t index, const std::vector<Row>& rows, size_t matches, size_t total_folders)
 {
     m_term_mutex.lock();
     int height = getmaxy(m_wresults_p);
     wmove(m_wresults_p, 0, 0);
     werase(m_wresults_p);
     wmove(m_wresults_p, height - 1, 0);
-    wprintw(m_wresults_p, " %zu/%zu", matches.size(), total_folders);
+    wprintw(m_wresults_p, " %zu/%zu", matches, total_folders);
     height--;
     wmove(m_wresults_p, height - 1, 0);
     size_t iter_index{0};
-    for (const auto& match : matches)
+    for (const auto& row : rows)
     {
         if (iter_index == index)
         {
             wattron(m_wresults_p, A_STANDOUT);
-            wprintw(m_wresults_p, "  %s", match.c_str());
+            waddstr(m_wresults_p, "  ");
+            draw_row(row);
             wattroff(m_wresults_p, A_STANDOUT);
         }
         else
         {
-            wprintw(m_wresults_p, " %s", match.c_str());
+            waddch(m_wresults_p, ' ');
+            draw_row(row);
         }
         height--;
         if (height == 0)
@@ -152,24 +255,165 @@ void Impl::draw_matches(size_t index, const std::set<std::string>& matches, size
         iter_index++;
     }
     wrefresh(m_wresults_p);
+    if (m_prefetcher && index < rows.size())
+    {
+        // Selected folder first, then its neighbours so holding TAB hits the cache
+        size_t count{0};
+        m_prefetch[count++] = rows[index].text;
+        if (index + 1 < rows.size())
+        {
+            m_prefetch[count++] = rows[index + 1].text;
+        }
+        if (index > 0)
+        {
+            m_prefetch[count++] = rows[index - 1].text;
+        }
+        m_preview_path.assign(rows[index].text);
+        m_prefetcher->request(std::span(m_prefetch).first(count));
+        draw_preview();
+    }
     wrefresh(m_winput_p);
     m_term_mutex.unlock();
 }
 
+/**
+ * Draws row text, toggling the highlight attribute once per span.
+ * Nested rows only draw the last folder of text, indented by its depth.
+ */
+void Impl::draw_row(const Row& row)
+{
+    size_t pos{0};
+    if (row.nested)
+    {
+        for (size_t level = 0; level < row.depth; level++)
+        {
+            draw_clipped("  ");
+        }
+        draw_clipped(row.branch == Branch::COLLAPSED ? "+ " : row.branch == Branch::EXPANDED ? "- " : "  ");
+        pos = row.text.rfind('/') + 1;
+    }
+    for (const auto& span : row.spans)
+    {
+        if (span.begin + span.length <= pos)
+        {
+            continue;
+        }
+        auto begin = std::max(span.begin, pos);
+        draw_clipped(row.text.substr(pos, begin - pos));
+        wattron(m_wresults_p, A_BOLD | A_UNDERLINE);
+        draw_clipped(row.text.substr(begin, span.begin + span.length - begin));
+        wattroff(m_wresults_p, A_BOLD | A_UNDERLINE);
+        pos = span.begin + span.length;
+    }
+    draw_clipped(row.text.substr(pos));
+    if (row.nested && row.branch != Branch::LEAF)
+    {
+        constexpr size_t COUNT_LENGTH{24};
+        std::array<char, COUNT_LENGTH> count{};
+        auto length = std::snprintf(count.data(), count.size(), " (%zu)", row.count);
+        draw_clipped(std::string_view(count.data(), static_cast<size_t>(std::max(length, 0))));
+    }
+}
+
+void Impl::enable_preview(const fs::path& root)
+{
+    m_term_mutex.lock();
+    int width = COLS * WPREVIEW_PERCENT / 100;
+    wresize(m_wresults_p, LINES - WINPUT_HEIGHT, COLS - width);
+    m_wpreview_p = newwin(LINES - WINPUT_HEIGHT, width, 0, COLS - width);
+    m_prefetcher.emplace(root, [this](std::string_view folder) {
+        m_term_mutex.lock();
+        if (folder == m_preview_path)
+        {
+            draw_preview();
+            wrefresh(m_winput_p);
+        }
+        m_term_mutex.unlock();
+    });
+    m_term_mutex.unlock();
+}
+
+/**
+ * Draws as much of text as fits before the right edge of the results window, so
+ * that long rows don't wrap into the next row. Every UTF-8 character takes one column.
+ */
+void Impl::draw_clipped(std::string_view text)
+{
+    auto columns = getmaxx(m_wresults_p) - getcurx(m_wresults_p);
+    size_t end{0};
+    for (; end < text.size(); end++)
+    {
+        if (!unicode::continuation(text[end]) && columns-- <= 0)
+        {
+            break;
+        }
+    }
+    waddnstr(m_wresults_p, text.data(), static_cast<int>(end));
+}
+
+/**
+ * Draws the cached listing of the selected folder, expects m_term_mutex to be held
+ */
+void Impl::draw_preview()
+{
+    int height = getmaxy(m_wpreview_p);
+    int width = getmaxx(m_wpreview_p);
+    werase(m_wpreview_p);
+    mvwvline(m_wpreview_p, 0, 0, ACS_VLINE, height);
+    auto listing = m_prefetcher->get(m_preview_path);
+    if (listing == nullptr)
+    {
+        mvwaddstr(m_wpreview_p, 0, 2, "...");
+    }
+    else
+    {
+        int line{0};
+        for (const auto& name : *listing)
+        {
+            if (line == height)
+            {
+                break;
+            }
+            mvwaddnstr(m_wpreview_p, line++, 2, name.c_str(), width - 2);
+        }
+    }
+    wrefresh(m_wpreview_p);
+}
+
+[[nodiscard]] size_t Impl::rows() const
+{
+    return static_cast<size_t>(getmaxy(m_wresults_p) - 1);
+}
+
 [[nodiscard]] int Impl::get_input() const
 {
     wmove(m_winput_p, m_winput_pos.y, m_winput_pos.x);
     wrefresh(m_winput_p);
-    return wgetch(m_winput_p);
+    auto input = wgetch(m_winput_p);
+    if (m_record.is_open())
+    {
+        auto now = std::chrono::steady_clock::now();
+        m_record << std::chrono::duration_cast<std::chrono::microseconds>(now - m_last_input).count() << ' ' << input << '\n';
+        m_last_input = now;
+    }
+    return input;
+}
+
+void Impl::record(const fs::path& file)
+{
+    m_record.open(file);
+    m_record << "# <microseconds since previous key> <key>\n";
+    m_last_input = std::chrono::steady_clock::now();
 }
 
 void Impl::setup(FILE*& tty_p, termios& orig_tty_p)
 {
     tty_p = fopen("/dev/tty", "r+");
     tcgetattr(fileno(tty_p), &orig_tty_p);
-    initscr(); // Create window
-    cbreak();  // Enable continous reading
-    noecho();  // Don't echo user input
+    setlocale(LC_ALL, ""); // Print UTF-8 folder names as characters
+    initscr();             // Create window
+    cbreak();              // Enable continous reading
+    noecho();              // Don't echo user input
     auto* screen = newterm(nullptr, tty_p, tty_p);
     set_term(screen);
 }
@@ -0,0 +1,478 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module unicode;
+
+namespace
+{
+/**
+ * Code points whose simple case folding adds delta, every stride-th one from first to last
+ */
+struct Fold
+{
+    char32_t first;
+    char32_t last;
+    int32_t delta;
+    uint32_t stride;
+};
+
+/**
+ * Simple case folding of the Latin, Greek and Cyrillic blocks, sorted by first
+ */
+constexpr std::array<Fold, 96> FOLDS{{
+    {.first = 0x0041, .last = 0x005A, .delta = 32, .stride = 1},
+    {.first = 0x00B5, .last = 0x00B5, .delta = 775, .stride = 1},
+    {.first = 0x00C0, .last = 0x00D6, .delta = 32, .stride = 1},
+    {.first = 0x00D8, .last = 0x00DE, .delta = 32, .stride = 1},
+    {.first = 0x0100, .last = 0x012E, .delta = 1, .stride = 2},
+    {.first = 0x0132, .last = 0x0136, .delta = 1, .stride = 2},
+    {.first = 0x0139, .last = 0x0147, .delta = 1, .stride = 2},
+    {.first = 0x014A, .last = 0x0176, .delta = 1, .stride = 2},
+    {.first = 0x0178, .last = 0x0178, .delta = -121, .stride = 1},
+    {.first = 0x0179, .last = 0x017D, .delta = 1, .stride = 2},
+    {.first = 0x017F, .last = 0x017F, .delta = -268, .stride = 1},
+    {.first = 0x0181, .last = 0x0181, .delta = 210, .stride = 1},
+    {.first = 0x0182, .last = 0x0184, .delta = 1, .stride = 2},
+    {.first = 0x0186, .last = 0x0186, .delta = 206, .stride = 1},
+    {.first = 0x0187, .last = 0x0187, .delta = 1, .stride = 1},
+    {.first = 0x0189, .last = 0x018A, .delta = 205, .stride = 1},
+    {.first = 0x018B, .last = 0x018B, .delta = 1, .stride = 1},
+    {.first = 0x018E, .last = 0x018E, .delta = 79, .stride = 1},
+    {.first = 0x018F, .last = 0x018F, .delta = 202, .stride = 1},
+    {.first = 0x0190, .last = 0x0190, .delta = 203, .stride = 1},
+    {.first = 0x0191, .last = 0x0191, .delta = 1, .stride = 1},
+    {.first = 0x0193, .last = 0x0193, .delta = 205, .stride = 1},
+    {.first = 0x0194, .last = 0x0194, .delta = 207, .stride = 1},
+    {.first = 0x0196, .last = 0x0196, .delta = 211, .stride = 1},
+    {.first = 0x0197, .last = 0x0197, .delta = 209, .stride = 1},
+    {.first = 0x0198, .last = 0x0198, .delta = 1, .stride = 1},
+    {.first = 0x019C, .last = 0x019C, .delta = 211, .stride = 1},
+    {.first = 0x019D, .last = 0x019D, .delta = 213, .stride = 1},
+    {.first = 0x019F, .last = 0x019F, .delta = 214, .stride = 1},
+    {.first = 0x01A0, .last = 0x01A4, .delta = 1, .stride = 2},
+    {.first = 0x01A6, .last = 0x01A6, .delta = 218, .stride = 1},
+    {.first = 0x01A7, .last = 0x01A7, .delta = 1, .stride = 1},
+    {.first = 0x01A9, .last = 0x01A9, .delta = 218, .stride = 1},
+    {.first = 0x01AC, .last = 0x01AC, .delta = 1, .stride = 1},
+    {.first = 0x01AE, .last = 0x01AE, .delta = 218, .stride = 1},
+    {.first = 0x01AF, .last = 0x01AF, .delta = 1, .stride = 1},
+    {.first = 0x01B1, .last = 0x01B2, .delta = 217, .stride = 1},
+    {.first = 0x01B3, .last = 0x01B5, .delta = 1, .stride = 2},
+    {.first = 0x01B7, .last = 0x01B7, .delta = 219, .stride = 1},
+    {.first = 0x01B8, .last = 0x01B8, .delta = 1, .stride = 1},
+    {.first = 0x01BC, .last = 0x01BC, .delta = 1, .stride = 1},
+    {.first = 0x01C4, .last = 0x01C4, .delta = 2, .stride = 1},
+    {.first = 0x01C5, .last = 0x01C5, .delta = 1, .stride = 1},
+    {.first = 0x01C7, .last = 0x01C7, .delta = 2, .stride = 1},
+    {.first = 0x01C8, .last = 0x01C8, .delta = 1, .stride = 1},
+    {.first = 0x01CA, .last = 0x01CA, .delta = 2, .stride = 1},
+    {.first = 0x01CB, .last = 0x01DB, .delta = 1, .stride = 2},
+    {.first = 0x01DE, .last = 0x01EE, .delta = 1, .stride = 2},
+    {.first = 0x01F1, .last = 0x01F1, .delta = 2, .stride = 1},
+    {.first = 0x01F2, .last = 0x01F4, .delta = 1, .stride = 2},
+    {.first = 0x01F6, .last = 0x01F6, .delta = -97, .stride = 1},
+    {.first = 0x01F7, .last = 0x01F7, .delta = -56, .stride = 1},
+    {.first = 0x01F8, .last = 0x021E, .delta = 1, .stride = 2},
+    {.first = 0x0220, .last = 0x0220, .delta = -130, .stride = 1},
+    {.first = 0x0222, .last = 0x0232, .delta = 1, .stride = 2},
+    {.first = 0x023A, .last = 0x023A, .delta = 10795, .stride = 1},
+    {.first = 0x023B, .last = 0x023B, .delta = 1, .stride = 1},
+    {.first = 0x023D, .last = 0x023D, .delta = -163, .stride = 1},
+    {.first = 0x023E, .last = 0x023E, .delta = 10792, .stride = 1},
+    {.first = 0x0241, .last = 0x0241, .delta = 1, .stride = 1},
+    {.first = 0x0243, .last = 0x0243, .delta = -195, .stride = 1},
+    {.first = 0x0244, .last = 0x0244, .delta = 69, .stride = 1},
+    {.first = 0x0245, .last = 0x0245, .delta = 71, .stride = 1},
+    {.first = 0x0246, .last = 0x024E, .delta = 1, .stride = 2},
+    {.first = 0x0345, .last = 0x0345, .delta = 116, .stride = 1},
+    {.first = 0x0370, .last = 0x0372, .delta = 1, .stride = 2},
+    {.first = 0x0376, .last = 0x0376, .delta = 1, .stride = 1},
+    {.first = 0x037F, .last = 0x037F, .delta = 116, .stride = 1},
+    {.first = 0x0386, .last = 0x0386, .delta = 38, .stride = 1},
+    {.first = 0x0388, .last = 0x038A, .delta = 37, .stride = 1},
+    {.first = 0x038C, .last = 0x038C, .delta = 64, .stride = 1},
+    {.first = 0x038E, .last = 0x038F, .delta = 63, .stride = 1},
+    {.first = 0x0391, .last = 0x03A1, .delta = 32, .stride = 1},
+    {.first = 0x03A3, .last = 0x03AB, .delta = 32, .stride = 1},
+    {.first = 0x03C2, .last = 0x03C2, .delta = 1, .stride = 1},
+    {.first = 0x03CF, .last = 0x03CF, .delta = 8, .stride = 1},
+    {.first = 0x03D0, .last = 0x03D0, .delta = -30, .stride = 1},
+    {.first = 0x03D1, .last = 0x03D1, .delta = -25, .stride = 1},
+    {.first = 0x03D5, .last = 0x03D5, .delta = -15, .stride = 1},
+    {.first = 0x03D6, .last = 0x03D6, .delta = -22, .stride = 1},
+    {.first = 0x03D8, .last = 0x03EE, .delta = 1, .stride = 2},
+    {.first = 0x03F0, .last = 0x03F0, .delta = -54, .stride = 1},
+    {.first = 0x03F1, .last = 0x03F1, .delta = -48, .stride = 1},
+    {.first = 0x03F4, .last = 0x03F4, .delta = -60, .stride = 1},
+    {.first = 0x03F5, .last = 0x03F5, .delta = -64, .stride = 1},
+    {.first = 0x03F7, .last = 0x03F7, .delta = 1, .stride = 1},
+    {.first = 0x03F9, .last = 0x03F9, .delta = -7, .stride = 1},
+    {.first = 0x03FA, .last = 0x03FA, .delta = 1, .stride = 1},
+    {.first = 0x03FD, .last = 0x03FF, .delta = -130, .stride = 1},
+    {.first = 0x0400, .last = 0x040F, .delta = 80, .stride = 1},
+    {.first = 0x0410, .last = 0x042F, .delta = 32, .stride = 1},
+    {.first = 0x0460, .last = 0x0480, .delta = 1, .stride = 2},
+    {.first = 0x048A, .last = 0x04BE, .delta = 1, .stride = 2},
+    {.first = 0x04C0, .last = 0x04C0, .delta = 15, .stride = 1},
+    {.first = 0x04C1, .last = 0x04CD, .delta = 1, .stride = 2},
+    {.first = 0x04D0, .last = 0x052E, .delta = 1, .stride = 2},
+}};
+
+/**
+ * Base code point and combining mark that compose to a precomposed code point
+ */
+struct Composition
+{
+    char32_t base;
+    char32_t mark;
+    char32_t composed;
+};
+
+/**
+ * Canonical compositions of the Latin, Greek and Cyrillic blocks with a mark of
+ * the combining diacritical marks block, sorted by base and mark
+ */
+constexpr std::array<Composition, 327> COMPOSITIONS{{
+    {0x0041, 0x0300, 0x00C0}, {0x0041, 0x0301, 0x00C1}, {0x0041, 0x0302, 0x00C2}, {0x0041, 0x0303, 0x00C3},
+    {0x0041, 0x0304, 0x0100}, {0x0041, 0x0306, 0x0102}, {0x0041, 0x0307, 0x0226}, {0x0041, 0x0308, 0x00C4},
+    {0x0041, 0x030A, 0x00C5}, {0x0041, 0x030C, 0x01CD}, {0x0041, 0x030F, 0x0200}, {0x0041, 0x0311, 0x0202},
+    {0x0041, 0x0328, 0x0104}, {0x0043, 0x0301, 0x0106}, {0x0043, 0x0302, 0x0108}, {0x0043, 0x0307, 0x010A},
+    {0x0043, 0x030C, 0x010C}, {0x0043, 0x0327, 0x00C7}, {0x0044, 0x030C, 0x010E}, {0x0045, 0x0300, 0x00C8},
+    {0x0045, 0x0301, 0x00C9}, {0x0045, 0x0302, 0x00CA}, {0x0045, 0x0304, 0x0112}, {0x0045, 0x0306, 0x0114},
+    {0x0045, 0x0307, 0x0116}, {0x0045, 0x0308, 0x00CB}, {0x0045, 0x030C, 0x011A}, {0x0045, 0x030F, 0x0204},
+    {0x0045, 0x0311, 0x0206}, {0x0045, 0x0327, 0x0228}, {0x0045, 0x0328, 0x0118}, {0x0047, 0x0301, 0x01F4},
+    {0x0047, 0x0302, 0x011C}, {0x0047, 0x0306, 0x011E}, {0x0047, 0x0307, 0x0120}, {0x0047, 0x030C, 0x01E6},
+    {0x0047, 0x0327, 0x0122}, {0x0048, 0x0302, 0x0124}, {0x0048, 0x030C, 0x021E}, {0x0049, 0x0300, 0x00CC},
+    {0x0049, 0x0301, 0x00CD}, {0x0049, 0x0302, 0x00CE}, {0x0049, 0x0303, 0x0128}, {0x0049, 0x0304, 0x012A},
+    {0x0049, 0x0306, 0x012C}, {0x0049, 0x0307, 0x0130}, {0x0049, 0x0308, 0x00CF}, {0x0049, 0x030C, 0x01CF},
+    {0x0049, 0x030F, 0x0208}, {0x0049, 0x0311, 0x020A}, {0x0049, 0x0328, 0x012E}, {0x004A, 0x0302, 0x0134},
+    {0x004B, 0x030C, 0x01E8}, {0x004B, 0x0327, 0x0136}, {0x004C, 0x0301, 0x0139}, {0x004C, 0x030C, 0x013D},
+    {0x004C, 0x0327, 0x013B}, {0x004E, 0x0300, 0x01F8}, {0x004E, 0x0301, 0x0143}, {0x004E, 0x0303, 0x00D1},
+    {0x004E, 0x030C, 0x0147}, {0x004E, 0x0327, 0x0145}, {0x004F, 0x0300, 0x00D2}, {0x004F, 0x0301, 0x00D3},
+    {0x004F, 0x0302, 0x00D4}, {0x004F, 0x0303, 0x00D5}, {0x004F, 0x0304, 0x014C}, {0x004F, 0x0306, 0x014E},
+    {0x004F, 0x0307, 0x022E}, {0x004F, 0x0308, 0x00D6}, {0x004F, 0x030B, 0x0150}, {0x004F, 0x030C, 0x01D1},
+    {0x004F, 0x030F, 0x020C}, {0x004F, 0x0311, 0x020E}, {0x004F, 0x031B, 0x01A0}, {0x004F, 0x0328, 0x01EA},
+    {0x0052, 0x0301, 0x0154}, {0x0052, 0x030C, 0x0158}, {0x0052, 0x030F, 0x0210}, {0x0052, 0x0311, 0x0212},
+    {0x0052, 0x0327, 0x0156}, {0x0053, 0x0301, 0x015A}, {0x0053, 0x0302, 0x015C}, {0x0053, 0x030C, 0x0160},
+    {0x0053, 0x0326, 0x0218}, {0x0053, 0x0327, 0x015E}, {0x0054, 0x030C, 0x0164}, {0x0054, 0x0326, 0x021A},
+    {0x0054, 0x0327, 0x0162}, {0x0055, 0x0300, 0x00D9}, {0x0055, 0x0301, 0x00DA}, {0x0055, 0x0302, 0x00DB},
+    {0x0055, 0x0303, 0x0168}, {0x0055, 0x0304, 0x016A}, {0x0055, 0x0306, 0x016C}, {0x0055, 0x0308, 0x00DC},
+    {0x0055, 0x030A, 0x016E}, {0x0055, 0x030B, 0x0170}, {0x0055, 0x030C, 0x01D3}, {0x0055, 0x030F, 0x0214},
+    {0x0055, 0x0311, 0x0216}, {0x0055, 0x031B, 0x01AF}, {0x0055, 0x0328, 0x0172}, {0x0057, 0x0302, 0x0174},
+    {0x0059, 0x0301, 0x00DD}, {0x0059, 0x0302, 0x0176}, {0x0059, 0x0304, 0x0232}, {0x0059, 0x0308, 0x0178},
+    {0x005A, 0x0301, 0x0179}, {0x005A, 0x0307, 0x017B}, {0x005A, 0x030C, 0x017D}, {0x0061, 0x0300, 0x00E0},
+    {0x0061, 0x0301, 0x00E1}, {0x0061, 0x0302, 0x00E2}, {0x0061, 0x0303, 0x00E3}, {0x0061, 0x0304, 0x0101},
+    {0x0061, 0x0306, 0x0103}, {0x0061, 0x0307, 0x0227}, {0x0061, 0x0308, 0x00E4}, {0x0061, 0x030A, 0x00E5},
+    {0x0061, 0x030C, 0x01CE}, {0x0061, 0x030F, 0x0201}, {0x0061, 0x0311, 0x0203}, {0x0061, 0x0328, 0x0105},
+    {0x0063, 0x0301, 0x0107}, {0x0063, 0x0302, 0x0109}, {0x0063, 0x0307, 0x010B}, {0x0063, 0x030C, 0x010D},
+    {0x0063, 0x0327, 0x00E7}, {0x0064, 0x030C, 0x010F}, {0x0065, 0x0300, 0x00E8}, {0x0065, 0x0301, 0x00E9},
+    {0x0065, 0x0302, 0x00EA}, {0x0065, 0x0304, 0x0113}, {0x0065, 0x0306, 0x0115}, {0x0065, 0x0307, 0x0117},
+    {0x0065, 0x0308, 0x00EB}, {0x0065, 0x030C, 0x011B}, {0x0065, 0x030F, 0x0205}, {0x0065, 0x0311, 0x0207},
+    {0x0065, 0x0327, 0x0229}, {0x0065, 0x0328, 0x0119}, {0x0067, 0x0301, 0x01F5}, {0x0067, 0x0302, 0x011D},
+    {0x0067, 0x0306, 0x011F}, {0x0067, 0x0307, 0x0121}, {0x0067, 0x030C, 0x01E7}, {0x0067, 0x0327, 0x0123},
+    {0x0068, 0x0302, 0x0125}, {0x0068, 0x030C, 0x021F}, {0x0069, 0x0300, 0x00EC}, {0x0069, 0x0301, 0x00ED},
+    {0x0069, 0x0302, 0x00EE}, {0x0069, 0x0303, 0x0129}, {0x0069, 0x0304, 0x012B}, {0x0069, 0x0306, 0x012D},
+    {0x0069, 0x0308, 0x00EF}, {0x0069, 0x030C, 0x01D0}, {0x0069, 0x030F, 0x0209}, {0x0069, 0x0311, 0x020B},
+    {0x0069, 0x0328, 0x012F}, {0x006A, 0x0302, 0x0135}, {0x006A, 0x030C, 0x01F0}, {0x006B, 0x030C, 0x01E9},
+    {0x006B, 0x0327, 0x0137}, {0x006C, 0x0301, 0x013A}, {0x006C, 0x030C, 0x013E}, {0x006C, 0x0327, 0x013C},
+    {0x006E, 0x0300, 0x01F9}, {0x006E, 0x0301, 0x0144}, {0x006E, 0x0303, 0x00F1}, {0x006E, 0x030C, 0x0148},
+    {0x006E, 0x0327, 0x0146}, {0x006F, 0x0300, 0x00F2}, {0x006F, 0x0301, 0x00F3}, {0x006F, 0x0302, 0x00F4},
+    {0x006F, 0x0303, 0x00F5}, {0x006F, 0x0304, 0x014D}, {0x006F, 0x0306, 0x014F}, {0x006F, 0x0307, 0x022F},
+    {0x006F, 0x0308, 0x00F6}, {0x006F, 0x030B, 0x0151}, {0x006F, 0x030C, 0x01D2}, {0x006F, 0x030F, 0x020D},
+    {0x006F, 0x0311, 0x020F}, {0x006F, 0x031B, 0x01A1}, {0x006F, 0x0328, 0x01EB}, {0x0072, 0x0301, 0x0155},
+    {0x0072, 0x030C, 0x0159}, {0x0072, 0x030F, 0x0211}, {0x0072, 0x0311, 0x0213}, {0x0072, 0x0327, 0x0157},
+    {0x0073, 0x0301, 0x015B}, {0x0073, 0x0302, 0x015D}, {0x0073, 0x030C, 0x0161}, {0x0073, 0x0326, 0x0219},
+    {0x0073, 0x0327, 0x015F}, {0x0074, 0x030C, 0x0165}, {0x0074, 0x0326, 0x021B}, {0x0074, 0x0327, 0x0163},
+    {0x0075, 0x0300, 0x00F9}, {0x0075, 0x0301, 0x00FA}, {0x0075, 0x0302, 0x00FB}, {0x0075, 0x0303, 0x0169},
+    {0x0075, 0x0304, 0x016B}, {0x0075, 0x0306, 0x016D}, {0x0075, 0x0308, 0x00FC}, {0x0075, 0x030A, 0x016F},
+    {0x0075, 0x030B, 0x0171}, {0x0075, 0x030C, 0x01D4}, {0x0075, 0x030F, 0x0215}, {0x0075, 0x0311, 0x0217},
+    {0x0075, 0x031B, 0x01B0}, {0x0075, 0x0328, 0x0173}, {0x0077, 0x0302, 0x0175}, {0x0079, 0x0301, 0x00FD},
+    {0x0079, 0x0302, 0x0177}, {0x0079, 0x0304, 0x0233}, {0x0079, 0x0308, 0x00FF}, {0x007A, 0x0301, 0x017A},
+    {0x007A, 0x0307, 0x017C}, {0x007A, 0x030C, 0x017E}, {0x00A8, 0x0301, 0x0385}, {0x00C4, 0x0304, 0x01DE},
+    {0x00C5, 0x0301, 0x01FA}, {0x00C6, 0x0301, 0x01FC}, {0x00C6, 0x0304, 0x01E2}, {0x00D5, 0x0304, 0x022C},
+    {0x00D6, 0x0304, 0x022A}, {0x00D8, 0x0301, 0x01FE}, {0x00DC, 0x0300, 0x01DB}, {0x00DC, 0x0301, 0x01D7},
+    {0x00DC, 0x0304, 0x01D5}, {0x00DC, 0x030C, 0x01D9}, {0x00E4, 0x0304, 0x01DF}, {0x00E5, 0x0301, 0x01FB},
+    {0x00E6, 0x0301, 0x01FD}, {0x00E6, 0x0304, 0x01E3}, {0x00F5, 0x0304, 0x022D}, {0x00F6, 0x0304, 0x022B},
+    {0x00F8, 0x0301, 0x01FF}, {0x00FC, 0x0300, 0x01DC}, {0x00FC, 0x0301, 0x01D8}, {0x00FC, 0x0304, 0x01D6},
+    {0x00FC, 0x030C, 0x01DA}, {0x01B7, 0x030C, 0x01EE}, {0x01EA, 0x0304, 0x01EC}, {0x01EB, 0x0304, 0x01ED},
+    {0x0226, 0x0304, 0x01E0}, {0x0227, 0x0304, 0x01E1}, {0x022E, 0x0304, 0x0230}, {0x022F, 0x0304, 0x0231},
+    {0x0292, 0x030C, 0x01EF}, {0x0391, 0x0301, 0x0386}, {0x0395, 0x0301, 0x0388}, {0x0397, 0x0301, 0x0389},
+    {0x0399, 0x0301, 0x038A}, {0x0399, 0x0308, 0x03AA}, {0x039F, 0x0301, 0x038C}, {0x03A5, 0x0301, 0x038E},
+    {0x03A5, 0x0308, 0x03AB}, {0x03A9, 0x0301, 0x038F}, {0x03B1, 0x0301, 0x03AC}, {0x03B5, 0x0301, 0x03AD},
+    {0x03B7, 0x0301, 0x03AE}, {0x03B9, 0x0301, 0x03AF}, {0x03B9, 0x0308, 0x03CA}, {0x03BF, 0x0301, 0x03CC},
+    {0x03C5, 0x0301, 0x03CD}, {0x03C5, 0x0308, 0x03CB}, {0x03C9, 0x0301, 0x03CE}, {0x03CA, 0x0301, 0x0390},
+    {0x03CB, 0x0301, 0x03B0}, {0x03D2, 0x0301, 0x03D3}, {0x03D2, 0x0308, 0x03D4}, {0x0406, 0x0308, 0x0407},
+    {0x0410, 0x0306, 0x04D0}, {0x0410, 0x0308, 0x04D2}, {0x0413, 0x0301, 0x0403}, {0x0415, 0x0300, 0x0400},
+    {0x0415, 0x0306, 0x04D6}, {0x0415, 0x0308, 0x0401}, {0x0416, 0x0306, 0x04C1}, {0x0416, 0x0308, 0x04DC},
+    {0x0417, 0x0308, 0x04DE}, {0x0418, 0x0300, 0x040D}, {0x0418, 0x0304, 0x04E2}, {0x0418, 0x0306, 0x0419},
+    {0x0418, 0x0308, 0x04E4}, {0x041A, 0x0301, 0x040C}, {0x041E, 0x0308, 0x04E6}, {0x0423, 0x0304, 0x04EE},
+    {0x0423, 0x0306, 0x040E}, {0x0423, 0x0308, 0x04F0}, {0x0423, 0x030B, 0x04F2}, {0x0427, 0x0308, 0x04F4},
+    {0x042B, 0x0308, 0x04F8}, {0x042D, 0x0308, 0x04EC}, {0x0430, 0x0306, 0x04D1}, {0x0430, 0x0308, 0x04D3},
+    {0x0433, 0x0301, 0x0453}, {0x0435, 0x0300, 0x0450}, {0x0435, 0x0306, 0x04D7}, {0x0435, 0x0308, 0x0451},
+    {0x0436, 0x0306, 0x04C2}, {0x0436, 0x0308, 0x04DD}, {0x0437, 0x0308, 0x04DF}, {0x0438, 0x0300, 0x045D},
+    {0x0438, 0x0304, 0x04E3}, {0x0438, 0x0306, 0x0439}, {0x0438, 0x0308, 0x04E5}, {0x043A, 0x0301, 0x045C},
+    {0x043E, 0x0308, 0x04E7}, {0x0443, 0x0304, 0x04EF}, {0x0443, 0x0306, 0x045E}, {0x0443, 0x0308, 0x04F1},
+    {0x0443, 0x030B, 0x04F3}, {0x0447, 0x0308, 0x04F5}, {0x044B, 0x0308, 0x04F9}, {0x044D, 0x0308, 0x04ED},
+    {0x0456, 0x0308, 0x0457}, {0x0474, 0x030F, 0x0476}, {0x0475, 0x030F, 0x0477}, {0x04D8, 0x0308, 0x04DA},
+    {0x04D9, 0x0308, 0x04DB}, {0x04E8, 0x0308, 0x04EA}, {0x04E9, 0x0308, 0x04EB},
+}};
+
+/**
+ * Combining diacritical marks block, the only marks composed
+ */
+constexpr char32_t FIRST_MARK{0x0300};
+constexpr char32_t LAST_MARK{0x036F};
+
+/**
+ * Bytes that are not valid UTF-8 decode to this offset plus the byte and are kept unchanged
+ */
+constexpr char32_t RAW_BYTE{0x110000};
+
+/**
+ * Largest code point encoded by 1, 2 and 3 bytes
+ */
+constexpr char32_t MAX_ONE{0x7F};
+constexpr char32_t MAX_TWO{0x7FF};
+constexpr char32_t MAX_THREE{0xFFFF};
+
+[[nodiscard]] char32_t fold_case(char32_t code)
+{
+    if (code < 'A' || code > FOLDS.back().last)
+    {
+        return code;
+    }
+    auto iter = std::ranges::upper_bound(FOLDS, code, {}, &Fold::first);
+    if (iter == FOLDS.begin())
+    {
+        return code;
+    }
+    --iter;
+    if (code > iter->last || (code - iter->first) % iter->stride != 0)
+    {
+        return code;
+    }
+    return static_cast<char32_t>(static_cast<int32_t>(code) + iter->delta);
+}
+
+[[nodiscard]] char32_t compose(char32_t base, char32_t mark)
+{
+    if (mark < FIRST_MARK || mark > LAST_MARK)
+    {
+        return 0;
+    }
+    auto iter = std::ranges::lower_bound(COMPOSITIONS, std::pair(base, mark), {}, [](const Composition& composition) { return std::pair(composition.base, composition.mark); });
+    return iter != COMPOSITIONS.end() && iter->base == base && iter->mark == mark ? iter->composed : 0;
+}
+
+/**
+ * Bytes of the UTF-8 sequence led by lead, 0 if lead can't start one
+ */
+[[nodiscard]] size_t sequence(uint8_t lead)
+{
+    constexpr uint8_t MIN_TWO{0xC2};
+    constexpr uint8_t MIN_THREE{0xE0};
+    constexpr uint8_t MIN_FOUR{0xF0};
+    constexpr uint8_t MAX_LEAD{0xF4};
+    if (lead <= MAX_ONE)
+    {
+        return 1;
+    }
+    if (lead < MIN_TWO || lead > MAX_LEAD)
+    {
+        return 0;
+    }
+    return lead < MIN_THREE ? 2 : lead < MIN_FOUR ? 3 : 4;
+}
+
+[[nodiscard]] char32_t raw(char byte)
+{
+    return RAW_BYTE + static_cast<uint8_t>(byte);
+}
+
+/**
+ * Decodes the code point starting at pos in text and advances pos past it
+ */
+[[nodiscard]] char32_t decode(std::string_view text, size_t& pos)
+{
+    constexpr uint8_t CONTINUATION_MASK{0xC0};
+    constexpr uint8_t CONTINUATION{0x80};
+    constexpr uint8_t PAYLOAD{0x3F};
+    constexpr unsigned PAYLOAD_BITS{6};
+    constexpr std::array<uint8_t, 5> LEAD_PAYLOAD{0, 0x7F, 0x1F, 0x0F, 0x07};
+    constexpr std::array<char32_t, 5> MIN_CODE{0, 0, MAX_ONE + 1, MAX_TWO + 1, MAX_THREE + 1};
+    constexpr char32_t MAX_CODE{0x10FFFF};
+
+    auto length = sequence(static_cast<uint8_t>(text[pos]));
+    if (length == 0 || pos + length > text.size())
+    {
+        return raw(text[pos++]);
+    }
+    char32_t code = static_cast<uint8_t>(text[pos]) & LEAD_PAYLOAD[length];
+    for (size_t index = 1; index < length; index++)
+    {
+        auto byte = static_cast<uint8_t>(text[pos + index]);
+        if ((byte & CONTINUATION_MASK) != CONTINUATION)
+        {
+            return raw(text[pos++]);
+        }
+        code = (code << PAYLOAD_BITS) | (byte & PAYLOAD);
+    }
+    if (code < MIN_CODE[length] || code > MAX_CODE)
+    {
+        return raw(text[pos++]);
+    }
+    pos += length;
+    return code;
+}
+
+/**
+ * Appends the UTF-8 encoding of code to out, raw bytes are appended unchanged
+ */
+void encode(char32_t code, std::string& out)
+{
+    constexpr char32_t PAYLOAD{0x3F};
+    constexpr char32_t CONTINUATION{0x80};
+    constexpr char32_t LEAD_TWO{0xC0};
+    constexpr char32_t LEAD_THREE{0xE0};
+    constexpr char32_t LEAD_FOUR{0xF0};
+    constexpr unsigned PAYLOAD_BITS{6};
+    if (code >= RAW_BYTE)
+    {
+        out.push_back(static_cast<char>(code - RAW_BYTE));
+    }
+    else if (code <= MAX_ONE)
+    {
+        out.push_back(static_cast<char>(code));
+    }
+    else if (code <= MAX_TWO)
+    {
+        out.push_back(static_cast<char>(LEAD_TWO | (code >> PAYLOAD_BITS)));
+        out.push_back(static_cast<char>(CONTINUATION | (code & PAYLOAD)));
+    }
+    else if (code <= MAX_THREE)
+    {
+        out.push_back(static_cast<char>(LEAD_THREE | (code >> (2 * PAYLOAD_BITS))));
+        out.push_back(static_cast<char>(CONTINUATION | ((code >> PAYLOAD_BITS) & PAYLOAD)));
+        out.push_back(static_cast<char>(CONTINUATION | (code & PAYLOAD)));
+    }
+    else
+    {
+        out.push_back(static_cast<char>(LEAD_FOUR | (code >> (3 * PAYLOAD_BITS))));
+        out.push_back(static_cast<char>(CONTINUATION | ((code >> (2 * PAYLOAD_BITS)) & PAYLOAD)));
+        out.push_back(static_cast<char>(CONTINUATION | ((code >> PAYLOAD_BITS) & PAYLOAD)));
+        out.push_back(static_cast<char>(CONTINUATION | (code & PAYLOAD)));
+    }
+}
+} // namespace
+
+namespace unicode
+{
+/**
+ * @param lead first byte of a character
+ * @return size_t bytes of the UTF-8 sequence led by lead, 1 for ASCII and bytes that can't lead one
+ */
+export [[nodiscard]] size_t length(char lead)
+{
+    return std::max<size_t>(sequence(static_cast<uint8_t>(lead)), 1);
+}
+
+/**
+ * @param byte byte of a UTF-8 string
+ * @return bool true if byte continues a multi-byte sequence instead of starting a character
+ */
+export [[nodiscard]] bool continuation(char byte)
+{
+    constexpr uint8_t MASK{0xC0};
+    constexpr uint8_t CONTINUATION{0x80};
+    return (static_cast<uint8_t>(byte) & MASK) == CONTINUATION;
+}
+
+/**
+ * Checks if text ends with a whole character rather than the start of a multi-byte sequence
+ * @param text UTF-8 text typed so far
+ */
+export [[nodiscard]] bool complete(std::string_view text)
+{
+    auto lead = text.size();
+    while (lead != 0 && text.size() - lead < 4 && continuation(text[lead - 1]))
+    {
+        lead--;
+    }
+    return lead == 0 || text.size() - (lead - 1) >= length(text[lead - 1]);
+}
+
+/**
+ * ASCII fast path, checks if normalize would return text unchanged without decoding it
+ * @param text path or search string
+ * @param fold whether case is folded
+ * @return bool true if text is ASCII and, when folding, has no upper case letters
+ */
+export [[nodiscard]] bool plain(std::string_view text, bool fold)
+{
+    return std::ranges::none_of(text, [fold](char c) { return static_cast<uint8_t>(c) > MAX_ONE || (fold && c >= 'A' && c <= 'Z'); });
+}
+
+/**
+ * Composes text to NFC and optionally folds its case.
+ * Only marks of the combining diacritical marks block directly following their
+ * base are composed and only the Latin, Greek and Cyrillic blocks are folded,
+ * which covers decomposed file names as written by macOS. Bytes that are not
+ * valid UTF-8 are kept unchanged.
+ * @param text UTF-8 text to normalize
+ * @param fold fold case so that normalized forms compare case insensitively
+ * @param out normalized text, replaced
+ * @param offsets if given, replaced by the offset in text of the character every byte of out belongs to, followed by text.size()
+ */
+export void normalize(std::string_view text, bool fold, std::string& out, std::vector<uint32_t>* offsets = nullptr)
+{
+    out.clear();
+    if (offsets != nullptr)
+    {
+        offsets->clear();
+    }
+    char32_t pending{0};
+    size_t begin{0};
+    auto flush = [&] {
+        encode(pending, out);
+        if (offsets != nullptr)
+        {
+            offsets->resize(out.size(), static_cast<uint32_t>(begin));
+        }
+    };
+    for (size_t pos = 0; pos < text.size();)
+    {
+        auto start = pos;
+        auto code = decode(text, pos);
+        if (fold)
+        {
+            code = fold_case(code);
+        }
+        if (start != 0)
+        {
+            if (auto composed = compose(pending, code); composed != 0)
+            {
+                pending = composed;
+                continue;
+            }
+            flush();
+        }
+        pending = code;
+        begin = start;
+    }
+    if (!text.empty())
+    {
+        flush();
+    }
+    if (offsets != nullptr)
+    {
+        offsets->push_back(static_cast<uint32_t>(text.size()));
+    }
+}
+} // namespace unicode
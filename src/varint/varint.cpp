@@ -0,0 +1,56 @@
+module;
+
+#include <concepts>
+#include <cstdint>
+#include <vector>
+
+export module varint;
+
+namespace varint
+{
+/**
+ * Byte types varints are stored in
+ */
+template <typename Byte>
+concept byte = std::same_as<Byte, char> || std::same_as<Byte, uint8_t>;
+
+constexpr uint8_t LOW_BITS{0x7F};
+constexpr uint8_t MORE_BIT{0x80};
+
+/**
+ * Appends value as a LEB128 varint
+ * @param out byte buffer to append to
+ * @param value value to encode
+ */
+export template <byte Byte, std::unsigned_integral Value>
+void put(std::vector<Byte>& out, Value value)
+{
+    while (value > LOW_BITS)
+    {
+        out.push_back(static_cast<Byte>((value & LOW_BITS) | MORE_BIT));
+        value >>= 7U;
+    }
+    out.push_back(static_cast<Byte>(value));
+}
+
+/**
+ * Reads a LEB128 varint
+ * @param data pointer to read from, advanced past the varint
+ * @return Value decoded value, varints must have been put from a Value
+ */
+export template <std::unsigned_integral Value, byte Byte>
+[[nodiscard]] Value get(const Byte*& data)
+{
+    Value value{0};
+    Value shift{0};
+    while ((static_cast<uint8_t>(*data) & MORE_BIT) != 0)
+    {
+        value |= static_cast<Value>(static_cast<uint8_t>(*data) & LOW_BITS) << shift;
+        shift += 7;
+        data++;
+    }
+    value |= static_cast<Value>(static_cast<uint8_t>(*data)) << shift;
+    data++;
+    return value;
+}
+} // namespace varint
@@ -0,0 +1,236 @@
+module;
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+export module vfs;
+
+namespace fs = std::filesystem;
+
+namespace vfs
+{
+/**
+ * Owner of directories that could not be stat'ed, (uid_t)-1 is no valid user id
+ */
+export constexpr uint32_t NO_OWNER{UINT32_MAX};
+
+/**
+ * Attributes of a directory
+ */
+export struct Stat
+{
+    int64_t mtime{0};         // Last modification, seconds since epoch
+    uint32_t owner{NO_OWNER}; // User id
+};
+
+/**
+ * Filesystem backend reading the real filesystem through std::filesystem and statx
+ */
+export class Native
+{
+  public:
+    /**
+     * Opened directory, empty since directories are read by their path
+     */
+    struct Handle
+    {
+    };
+
+    /**
+     * @param root directory to walk
+     * @return Handle of root
+     */
+    [[nodiscard]] Handle open(const fs::path& /*root*/) const
+    {
+        return {};
+    }
+
+    /**
+     * Reports the subdirectories of directory, unreadable directories have none
+     * @param directory directory to read
+     * @param path path of directory
+     * @param func callback taking the std::string_view name, bool symlink and Handle of every subdirectory
+     * @return size_t number of entries of any type in directory
+     */
+    size_t list(const Handle& /*directory*/, const fs::path& path, auto&& func) const
+    {
+        size_t entries{0};
+        std::error_code error;
+        for (auto iter = fs::directory_iterator(path, fs::directory_options::skip_permission_denied, error); !error && iter != fs::directory_iterator(); iter.increment(error))
+        {
+            entries++;
+            std::error_code entry_error;
+            if (iter->is_directory(entry_error))
+            {
+                func(std::string_view(iter->path().filename().native()), iter->is_symlink(entry_error), Handle{});
+            }
+        }
+        return entries;
+    }
+
+    /**
+     * @param directory directory to stat
+     * @param path path of directory
+     * @return Stat of directory, default with NO_OWNER if it can't be read
+     */
+    [[nodiscard]] Stat stat(const Handle& /*directory*/, const fs::path& path) const
+    {
+        struct statx buffer{};
+        if (statx(AT_FDCWD, path.c_str(), 0, STATX_MTIME | STATX_UID, &buffer) != 0)
+        {
+            return {};
+        }
+        return {.mtime = buffer.stx_mtime.tv_sec, .owner = buffer.stx_uid};
+    }
+};
+
+/**
+ * Shape of a generated tree, counts and lengths are drawn uniformly from their ranges
+ */
+export struct Shape
+{
+    size_t min_fanout{8};                 // Subdirectories per directory above max depth
+    size_t max_fanout{8};
+    size_t depth{4};                      // Levels of directories below root
+    size_t min_name{3};                   // Bytes per directory name
+    size_t max_name{12};
+    size_t files{0};                      // Non directory entries per directory
+    std::chrono::microseconds latency{0}; // Delay of every directory read
+    std::chrono::seconds max_age{0};      // Directories are modified up to max_age before generation
+    uint64_t seed{1};                     // Same seed and shape give the same tree
+};
+
+/**
+ * In memory filesystem backend holding a deterministic generated tree.
+ * Directories are stored breadth first so that the children of a directory are
+ * contiguous, names are kept in one buffer.
+ */
+export class Synthetic
+{
+  public:
+    /**
+     * Node index of a directory
+     */
+    using Handle = uint32_t;
+
+    /**
+     * @param shape tree to generate
+     */
+    explicit Synthetic(const Shape& shape) : m_latency(shape.latency), m_files(shape.files)
+    {
+        constexpr uint64_t MULTIPLIER{6364136223846793005ULL};
+        constexpr uint64_t INCREMENT{1442695040888963407ULL};
+        constexpr size_t LETTERS{26};
+        uint64_t state{shape.seed};
+        auto random = [&](size_t low, size_t high) {
+            state = state * MULTIPLIER + INCREMENT;
+            return low + static_cast<size_t>(state >> 33U) % (std::max(low, high) - low + 1);
+        };
+        auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        m_nodes.push_back({.name = 0, .length = 0, .first = 1, .count = 0, .depth = 0, .mtime = now});
+        for (size_t node = 0; node < m_nodes.size(); node++)
+        {
+            if (m_nodes[node].depth == shape.depth)
+            {
+                continue;
+            }
+            auto count = random(shape.min_fanout, shape.max_fanout);
+            m_nodes[node].first = static_cast<uint32_t>(m_nodes.size());
+            m_nodes[node].count = static_cast<uint32_t>(count);
+            size_t width{1};
+            for (auto last = count - 1; last >= LETTERS; last /= LETTERS)
+            {
+                width++;
+            }
+            for (size_t child = 0; child < count; child++)
+            {
+                // Names start with the sibling index as width base 26 digits so siblings never collide
+                auto begin = m_names.size();
+                for (auto index = child; m_names.size() - begin < width; index /= LETTERS)
+                {
+                    m_names.push_back(static_cast<char>('a' + index % LETTERS));
+                }
+                auto length = std::max(random(shape.min_name, shape.max_name), m_names.size() - begin);
+                while (m_names.size() - begin < length)
+                {
+                    m_names.push_back(static_cast<char>('a' + random(0, LETTERS - 1)));
+                }
+                auto age = static_cast<int64_t>(random(0, static_cast<size_t>(shape.max_age.count())));
+                m_nodes.push_back({.name = static_cast<uint32_t>(begin), .length = static_cast<uint32_t>(length), .first = 0, .count = 0, .depth = m_nodes[node].depth + 1, .mtime = now - age});
+            }
+        }
+    }
+
+    /**
+     * @return Handle of the generated root, regardless of root
+     */
+    [[nodiscard]] Handle open(const fs::path& /*root*/) const
+    {
+        return 0;
+    }
+
+    /**
+     * Reports the subdirectories of directory after the injected latency
+     * @param directory directory to read
+     * @param func callback taking the std::string_view name, bool symlink and Handle of every subdirectory
+     * @return size_t number of entries of any type in directory
+     */
+    size_t list(const Handle& directory, const fs::path& /*path*/, auto&& func) const
+    {
+        if (m_latency.count() != 0)
+        {
+            std::this_thread::sleep_for(m_latency);
+        }
+        const auto& node = m_nodes[directory];
+        for (auto child = node.first; child < node.first + node.count; child++)
+        {
+            func(std::string_view(m_names).substr(m_nodes[child].name, m_nodes[child].length), false, child);
+        }
+        return node.count + m_files;
+    }
+
+    /**
+     * @param directory directory to stat
+     * @return Stat of directory
+     */
+    [[nodiscard]] Stat stat(const Handle& directory, const fs::path& /*path*/) const
+    {
+        return {.mtime = m_nodes[directory].mtime, .owner = 0};
+    }
+
+    /**
+     * @return size_t number of generated directories, excluding root
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return m_nodes.size() - 1;
+    }
+
+  private:
+    struct Node
+    {
+        uint32_t name;
+        uint32_t length;
+        uint32_t first;
+        uint32_t count;
+        size_t depth;
+        int64_t mtime;
+    };
+
+    std::chrono::microseconds m_latency;
+    size_t m_files;
+    std::vector<Node> m_nodes;
+    std::string m_names;
+};
+} // namespace vfs
@@ -0,0 +1,185 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+export module walk;
+import vfs;
+
+namespace fs = std::filesystem;
+
+namespace walk
+{
+/**
+ * Number reported as the parent of top level folders
+ */
+export constexpr uint32_t ROOT{UINT32_MAX};
+
+/**
+ * Attributes of a directory collected while reading it
+ */
+export struct Metadata
+{
+    uint32_t entries{0};           // Number of entries of any type
+    int64_t mtime{0};              // Last modification, seconds since epoch
+    uint32_t owner{vfs::NO_OWNER}; // User id
+};
+
+/**
+ * Directory walk that reads shallow directories first.
+ * Directories wait in a priority queue ordered by round, then depth, then the
+ * order they were found in. Every folder below a top level directory counts
+ * against the budget of that subtree, and each exhausted budget moves the rest of
+ * the subtree one round back. Huge subtrees such as caches are therefore read
+ * after the shallow parts of all other subtrees instead of before them.
+ * @tparam FS filesystem backend such as vfs::Native
+ */
+export template <typename FS>
+class Walker
+{
+  public:
+    /**
+     * @param filesystem backend to read directories from, must outlive the walker
+     * @param root directory to walk
+     * @param budget folders a top level subtree may yield per round, 0 for a plain breadth-first walk
+     * @param stat stat every directory read to fill the mtime and owner of its Metadata, the entries are always counted
+     */
+    Walker(const FS& filesystem, const fs::path& root, size_t budget = 0, bool stat = false) : m_fs(filesystem), m_root(root), m_budget(budget), m_stat(stat)
+    {
+        m_pending.push_back({.round = 0, .depth = 0, .order = m_order++, .subtree = NO_SUBTREE, .id = ROOT, .relative = {}, .handle = m_fs.open(root)});
+    }
+
+    /**
+     * Reads the next directory in priority order.
+     * Folders are numbered by the order they are found in, starting at 0.
+     * @param found callback taking the std::string_view path relative to root, the size_t depth and the uint32_t number of
+     *              the parent folder, ROOT for top level folders, of every folder found
+     * @param read callback taking the uint32_t number and Metadata of the folder read, not called for root
+     * @return bool false once every directory has been read
+     */
+    bool step(auto&& found, auto&& read)
+    {
+        while (!m_pending.empty())
+        {
+            std::ranges::pop_heap(m_pending, Later{});
+            auto directory = std::move(m_pending.back());
+            m_pending.pop_back();
+
+            // Budgets are spent after directories are queued, so priorities are refreshed lazily
+            auto current = round(directory.subtree);
+            if (current > directory.round)
+            {
+                directory.round = current;
+                push(std::move(directory));
+                continue;
+            }
+            auto metadata = this->read(directory, found);
+            if (directory.id != ROOT)
+            {
+                read(directory.id, metadata);
+            }
+            return true;
+        }
+        return false;
+    }
+
+  private:
+    static constexpr uint32_t NO_SUBTREE{UINT32_MAX};
+
+    struct Directory
+    {
+        size_t round;
+        size_t depth;
+        size_t order;
+        uint32_t subtree;
+        uint32_t id;
+        std::string relative;
+        [[no_unique_address]] typename FS::Handle handle;
+    };
+
+    /**
+     * Heap order, the directory read next compares greatest
+     */
+    struct Later
+    {
+        bool operator()(const Directory& lhs, const Directory& rhs) const
+        {
+            if (lhs.round != rhs.round)
+            {
+                return lhs.round > rhs.round;
+            }
+            if (lhs.depth != rhs.depth)
+            {
+                return lhs.depth > rhs.depth;
+            }
+            return lhs.order > rhs.order;
+        }
+    };
+
+    [[nodiscard]] size_t round(uint32_t subtree) const
+    {
+        return m_budget == 0 || subtree == NO_SUBTREE ? 0 : m_found[subtree] / m_budget;
+    }
+
+    void push(Directory&& directory)
+    {
+        m_pending.push_back(std::move(directory));
+        std::ranges::push_heap(m_pending, Later{});
+    }
+
+    /**
+     * Reports the folders in directory and queues them, directory symlinks are reported but not followed
+     * @return Metadata of directory
+     */
+    Metadata read(const Directory& directory, auto& found)
+    {
+        // Queued directories only keep their relative path, the full one is built when reading them
+        m_path = m_root;
+        if (!directory.relative.empty())
+        {
+            m_path /= directory.relative;
+        }
+        Metadata metadata;
+        if (m_stat)
+        {
+            auto stat = m_fs.stat(directory.handle, m_path);
+            metadata.mtime = stat.mtime;
+            metadata.owner = stat.owner;
+        }
+        auto entries = m_fs.list(directory.handle, m_path, [&](std::string_view name, bool symlink, typename FS::Handle handle) {
+            auto relative = directory.relative.empty() ? std::string(name) : directory.relative + '/' + std::string(name);
+            auto subtree = directory.subtree;
+            if (subtree == NO_SUBTREE)
+            {
+                subtree = static_cast<uint32_t>(m_found.size());
+                m_found.push_back(0);
+            }
+            m_found[subtree]++;
+            found(std::string_view(relative), directory.depth + 1, directory.id);
+            auto id = m_next_id++;
+            if (!symlink)
+            {
+                push({.round = round(subtree), .depth = directory.depth + 1, .order = m_order++, .subtree = subtree, .id = id, .relative = std::move(relative), .handle = std::move(handle)});
+            }
+        });
+        metadata.entries = static_cast<uint32_t>(std::min<size_t>(entries, UINT32_MAX));
+        return metadata;
+    }
+
+    const FS& m_fs;
+    fs::path m_root;
+    fs::path m_path;
+    size_t m_budget;
+    bool m_stat;
+    size_t m_order{0};
+    uint32_t m_next_id{0};
+    std::vector<Directory> m_pending;
+    std::vector<size_t> m_found;
+};
+} // namespace walk
@@ -0,0 +1,117 @@
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+import radix;
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+/**
+ * Generates count folder paths in the unsorted order a directory walk returns them.
+ * Paths are built from a fixed set of names so they share long prefixes like real trees.
+ */
+std::vector<std::string> generate_paths(size_t count)
+{
+    static const std::vector<std::string> names{"src", "core", "build", "cache", "tests", "docs", "services", "deploy", "lib", "tools", "include", "node_modules"};
+    constexpr uint64_t MULTIPLIER{6364136223846793005ULL};
+    constexpr uint64_t INCREMENT{1442695040888963407ULL};
+    constexpr size_t MAX_DEPTH{8};
+    uint64_t state{count};
+    auto next = [&](size_t bound) {
+        state = state * MULTIPLIER + INCREMENT;
+        return static_cast<size_t>(state >> 33U) % bound;
+    };
+
+    std::vector<std::string> paths;
+    paths.reserve(count);
+    std::string path;
+    while (paths.size() < count)
+    {
+        auto depth = 1 + next(MAX_DEPTH);
+        path.clear();
+        for (size_t level = 0; level < depth; level++)
+        {
+            path.append(level == 0 ? "" : "/").append(names[next(names.size())]).append(std::to_string(next(level + 3)));
+        }
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+/**
+ * @return double milliseconds elapsed since start
+ */
+double elapsed(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+} // namespace
+
+/**
+ * Compares ordering folders by std::set insertion against the parallel radix sort
+ * Usage: bench-sort [entries...], defaults to 1M and 5M entries
+ */
+int main(int argc, const char* argv[])
+{
+    constexpr size_t MILLION{1000000};
+    std::vector<size_t> sizes{MILLION, 5 * MILLION};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int arg = 1; arg < argc; arg++)
+        {
+            sizes.push_back(std::stoul(argv[arg])); /// NOLINT
+        }
+    }
+
+    for (auto size : sizes)
+    {
+        auto paths = generate_paths(size);
+
+        auto start = Clock::now();
+        std::set<std::string> set;
+        for (const auto& path : paths)
+        {
+            set.insert(path);
+        }
+        std::vector<std::string_view> set_order(set.begin(), set.end());
+        auto set_ms = elapsed(start);
+
+        std::vector<std::string_view> keys(paths.begin(), paths.end());
+        start = Clock::now();
+        auto ids = radix::sort(keys, 1);
+        auto serial_ms = elapsed(start);
+
+        start = Clock::now();
+        ids = radix::sort(keys);
+        auto parallel_ms = elapsed(start);
+
+        // The set drops duplicate paths, the radix sort keeps them adjacent
+        std::vector<std::string_view> radix_order;
+        for (auto id : ids)
+        {
+            if (radix_order.empty() || radix_order.back() != keys[id])
+            {
+                radix_order.push_back(keys[id]);
+            }
+        }
+        if (radix_order != set_order)
+        {
+            std::cerr << "Radix sort order differs from std::set order for " << size << " entries\n";
+            return EXIT_FAILURE;
+        }
+
+        std::cout << size << " entries: std::set " << set_ms << " ms, radix 1 thread " << serial_ms << " ms, radix "
+                  << std::max(1U, std::thread::hardware_concurrency()) << " threads " << parallel_ms << " ms\n";
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+
+#include "alloc_counter.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+import finder;
+import parser;
+import tui;
+
+/**
+ * Folders below alpha/src/core, far more than fit on a screen
+ */
+constexpr size_t MODULES{2500};
+
+/**
+ * Tui backend that only counts frames, gmock records calls on the heap so it can't be used here
+ */
+class CountingImpl
+{
+  public:
+    static void draw_input(const std::string& /*input*/)
+    {
+    }
+
+    static void draw_matches(size_t /*index*/, const std::vector<tui::Row>& /*rows*/, size_t /*matches*/, size_t /*total_folders*/)
+    {
+        frames++;
+    }
+
+    [[nodiscard]] static size_t rows()
+    {
+        constexpr size_t ROWS{20};
+        return ROWS;
+    }
+
+    [[nodiscard]] static int get_input()
+    {
+        return 0;
+    }
+
+    static inline std::atomic<size_t> frames{0}; /// NOLINT
+};
+
+/**
+ * Testclass checking that handling keystrokes does not allocate once warmed up
+ */
+class TestFinderAlloc : public testing::TestWithParam<std::vector<parser::Command>>
+{
+  protected:
+    void SetUp() override
+    {
+        m_root = std::filesystem::temp_directory_path() / ("fzf-folder-alloc-" + std::to_string(getpid()));
+        for (const auto* project : {"alpha", "beta", "gamma", "delta"})
+        {
+            for (const auto* folder : {"src/core", "src/tui", "build/cache/objects", "tests/unit", "docs/images"})
+            {
+                std::filesystem::create_directories(m_root / project / folder);
+            }
+        }
+        for (size_t module = 0; module < MODULES; module++)
+        {
+            std::filesystem::create_directories(m_root / "alpha/src/core" / ("module" + std::to_string(module)));
+        }
+        CountingImpl::frames = 0;
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_root);
+    }
+
+    /**
+     * Types keys and waits until the search thread has drawn each resulting frame
+     * @param keys characters to type, '\b' for backspace, '+'/'-' to navigate, '>'/'<' to expand/collapse
+     */
+    static void type(auto& finder, auto& tui, std::string_view keys)
+    {
+        for (auto key : keys)
+        {
+            auto frames = CountingImpl::frames.load();
+            if (key == '+' || key == '-')
+            {
+                finder.update_index(key == '+' ? 1 : -1);
+            }
+            else if (key == '>' || key == '<')
+            {
+                finder.update_fold(key == '>' ? parser::Toggle::EXPAND : parser::Toggle::COLLAPSE);
+            }
+            else
+            {
+                finder.update_search(key == '\b' ? '\0' : key, tui);
+            }
+            while (CountingImpl::frames == frames)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::filesystem::path m_root;
+};
+
+/**
+ * Keystrokes after warm-up must neither allocate in the main nor in the search thread
+ */
+TEST_P(TestFinderAlloc, testSteadyStateKeystrokes)
+{
+    tui::Tui<CountingImpl> tui;
+    finder::Finder finder(tui, m_root, GetParam());
+    while (!finder.indexed())
+    {
+        std::this_thread::yield();
+    }
+
+    type(finder, tui, "src/core+++-><\b\b\b\b\b\b\b\b\bcache\b\b\b\b\b");
+
+    stubAlloc::start_counting(stubAlloc::Threads::ALL);
+    type(finder, tui, "tests+-><\b\b\b\b\balpha/docs++\b\b\b\b\b\b\b\b\b\bobj\b\b\b");
+    auto allocations = stubAlloc::stop_counting();
+
+    EXPECT_EQ(allocations, 0) << "Heap allocations while handling keystrokes after warm-up";
+}
+
+/**
+ * Scrolling through thousands of matches must not grow any per row state
+ */
+TEST_P(TestFinderAlloc, testScrollThousandsOfRows)
+{
+    tui::Tui<CountingImpl> tui;
+    finder::Finder finder(tui, m_root, GetParam());
+    while (!finder.indexed())
+    {
+        std::this_thread::yield();
+    }
+
+    // Globs match whole paths
+    std::string search = std::ranges::find(GetParam(), parser::Command::GLOB) != GetParam().end() ? "**/module*" : "module";
+    std::string erase(search.size(), '\b');
+    // Expands alpha/src/core for the tree view, a no-op otherwise
+    type(finder, tui, search + ">+>+>+-" + erase);
+    const std::string down(MODULES, '+');
+    const std::string up(MODULES, '-');
+
+    stubAlloc::start_counting(stubAlloc::Threads::ALL);
+    type(finder, tui, search);
+    type(finder, tui, down);
+    type(finder, tui, up);
+    type(finder, tui, erase);
+    auto allocations = stubAlloc::stop_counting();
+
+    EXPECT_EQ(allocations, 0) << "Heap allocations while scrolling after warm-up";
+}
+
+/**
+ * Searches up to the reserved length parse without allocating, however many terms they hold
+ */
+TEST_P(TestFinderAlloc, testLongSearch)
+{
+    constexpr size_t LENGTH{250};
+    tui::Tui<CountingImpl> tui;
+    finder::Finder finder(tui, m_root, GetParam());
+    while (!finder.indexed())
+    {
+        std::this_thread::yield();
+    }
+
+    std::string search;
+    for (size_t term = 0; search.size() + 8 < LENGTH; term++)
+    {
+        search += std::array{"a ", "'s ", "!zz ", "| ", "^al "}[term % 5];
+    }
+    std::string erase(search.size(), '\b');
+    type(finder, tui, "src\b\b\b");
+
+    stubAlloc::start_counting(stubAlloc::Threads::ALL);
+    type(finder, tui, search);
+    type(finder, tui, erase);
+    auto allocations = stubAlloc::stop_counting();
+
+    EXPECT_EQ(allocations, 0) << "Heap allocations while typing a " << search.size() << " byte search";
+}
+
+/**
+ * Storage, index, pattern and view options that change the keystroke path
+ */
+INSTANTIATE_TEST_SUITE_P(SweepCommands,
+                         TestFinderAlloc,
+                         testing::Values(std::vector<parser::Command>{},
+                                         std::vector<parser::Command>{parser::Command::TRIGRAM},
+                                         std::vector<parser::Command>{parser::Command::COMPACT},
+                                         std::vector<parser::Command>{parser::Command::TRIGRAM, parser::Command::COMPACT},
+                                         std::vector<parser::Command>{parser::Command::GLOB},
+                                         std::vector<parser::Command>{parser::Command::REGEX, parser::Command::TRIGRAM},
+                                         std::vector<parser::Command>{parser::Command::TREE, parser::Command::TRIGRAM}));
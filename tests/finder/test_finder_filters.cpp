@@ -0,0 +1,199 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+import finder;
+import parser;
+import tui;
+
+namespace
+{
+/**
+ * Folders below the test root, all changed 10 days ago except b/new
+ */
+const std::vector<std::string> FOLDERS{"a", "a/old", "a/old/deep", "b", "b/new"}; /// NOLINT
+
+/**
+ * Files below the test root, giving b/new three entries and every other folder at most one
+ */
+const std::vector<std::string> FILES{"b/new/1", "b/new/2", "b/new/3"}; /// NOLINT
+
+/**
+ * Symlink to a below the test root, listed but never read so its owner and entries are unknown
+ */
+const std::string LINK{"c"}; /// NOLINT
+
+/**
+ * Filters with every bound given, unset ones as nullopt
+ */
+parser::Filters make_filters(std::optional<std::chrono::seconds> changed_within, std::optional<size_t> min_depth, std::optional<size_t> max_depth, std::optional<size_t> min_entries,
+                             std::optional<uint32_t> owner)
+{
+    return {.changed_within = changed_within, .min_depth = min_depth, .max_depth = max_depth, .min_entries = min_entries, .owner = owner};
+}
+} // namespace
+
+/**
+ * Tui backend keeping the paths of the last drawn frame
+ */
+class RecordingImpl
+{
+  public:
+    static void draw_input(const std::string& /*input*/)
+    {
+    }
+
+    static void draw_matches(size_t /*index*/, const std::vector<tui::Row>& rows, size_t /*matches*/, size_t /*total_folders*/)
+    {
+        std::scoped_lock lock(mutex);
+        paths.clear();
+        for (const auto& row : rows)
+        {
+            paths.emplace_back(row.text);
+        }
+        frames++;
+    }
+
+    [[nodiscard]] static size_t rows()
+    {
+        constexpr size_t ROWS{20};
+        return ROWS;
+    }
+
+    [[nodiscard]] static int get_input()
+    {
+        return 0;
+    }
+
+    static inline std::mutex mutex;               /// NOLINT
+    static inline std::vector<std::string> paths; /// NOLINT
+    static inline std::atomic<size_t> frames{0};  /// NOLINT
+};
+
+/**
+ * Struct representing IO for filtered searches
+ */
+struct FilterIO
+{
+    parser::Filters filters;
+    std::string_view search;
+    std::vector<std::string> output;
+    std::vector<parser::Command> commands{};
+};
+
+/**
+ * Testclass checking that filters and searches together select the right folders
+ */
+class TestFinderFilters : public testing::TestWithParam<FilterIO>
+{
+  protected:
+    void SetUp() override
+    {
+        m_root = std::filesystem::temp_directory_path() / ("fzf-folder-filters-" + std::to_string(getpid()));
+        for (const auto& folder : FOLDERS)
+        {
+            std::filesystem::create_directories(m_root / folder);
+        }
+        for (const auto& file : FILES)
+        {
+            std::ofstream(m_root / file).put('\n');
+        }
+        std::filesystem::create_directory_symlink("a", m_root / LINK);
+        // Children are created first since creating them touches their parent
+        auto old = std::filesystem::file_time_type::clock::now() - std::chrono::days(10);
+        for (const auto& folder : FOLDERS)
+        {
+            std::filesystem::last_write_time(m_root / folder, folder == "b/new" ? std::filesystem::file_time_type::clock::now() : old);
+        }
+        RecordingImpl::frames = 0;
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_root);
+    }
+
+    std::filesystem::path m_root;
+};
+
+/**
+ * Types the search once indexing is done and compares the drawn folders, '\b' erases
+ */
+TEST_P(TestFinderFilters, testFilteredSearch)
+{
+    auto [filters, search, output, commands] = GetParam();
+    tui::Tui<RecordingImpl> tui;
+    finder::Finder finder(tui, m_root, commands, filters);
+    while (!finder.indexed())
+    {
+        std::this_thread::yield();
+    }
+    for (auto key : search)
+    {
+        auto frames = RecordingImpl::frames.load();
+        finder.update_search(key == '\b' ? '\0' : key, tui);
+        while (RecordingImpl::frames == frames)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    std::vector<std::string> paths;
+    {
+        std::scoped_lock lock(RecordingImpl::mutex);
+        paths = RecordingImpl::paths;
+    }
+    std::ranges::sort(paths);
+    EXPECT_EQ(paths, output) << "Search: " << search;
+}
+
+/**
+ * Filters, search and the folders expected to be shown
+ */
+INSTANTIATE_TEST_SUITE_P(SweepFilters,
+                         TestFinderFilters,
+                         testing::Values(
+                             // Filters alone
+                             FilterIO{.filters = make_filters(std::nullopt, 2, std::nullopt, std::nullopt, std::nullopt), .search = "", .output{"a/old", "a/old/deep", "b/new"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, 1, std::nullopt, std::nullopt), .search = "", .output{"a", "b", "c"}},
+                             FilterIO{.filters = make_filters(std::nullopt, 2, 2, std::nullopt, std::nullopt), .search = "", .output{"a/old", "b/new"}},
+                             FilterIO{.filters = make_filters(std::nullopt, 4, std::nullopt, std::nullopt, std::nullopt), .search = "", .output{}},
+                             FilterIO{.filters = make_filters(std::chrono::days(1), std::nullopt, std::nullopt, std::nullopt, std::nullopt), .search = "", .output{"b/new"}},
+                             FilterIO{.filters = make_filters(std::chrono::weeks(2), std::nullopt, std::nullopt, std::nullopt, std::nullopt), .search = "", .output{"a", "a/old", "a/old/deep", "b", "b/new"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, std::nullopt, 0, std::nullopt), .search = "", .output{"a", "a/old", "a/old/deep", "b", "b/new", "c"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, std::nullopt, 1, std::nullopt), .search = "", .output{"a", "a/old", "b", "b/new"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, std::nullopt, 3, std::nullopt), .search = "", .output{"b/new"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, std::nullopt, 4, std::nullopt), .search = "", .output{}},
+                             // The symlinked folder has no known owner, even when running as root
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, std::nullopt, std::nullopt, getuid()), .search = "", .output{"a", "a/old", "a/old/deep", "b", "b/new"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, std::nullopt, std::nullopt, getuid() + 1), .search = "", .output{}},
+                             // Filters combined with each other
+                             FilterIO{.filters = make_filters(std::chrono::days(1), std::nullopt, 1, std::nullopt, std::nullopt), .search = "", .output{}},
+                             FilterIO{.filters = make_filters(std::chrono::weeks(2), 3, std::nullopt, std::nullopt, getuid()), .search = "", .output{"a/old/deep"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, 1, 1, getuid()), .search = "", .output{"a", "b"}},
+                             // Filters combined with searches
+                             FilterIO{.filters = make_filters(std::nullopt, 2, std::nullopt, std::nullopt, std::nullopt), .search = "old", .output{"a/old", "a/old/deep"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, 2, std::nullopt, std::nullopt), .search = "old", .output{"a/old"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, std::nullopt, 1, std::nullopt), .search = "old", .output{"a/old"}},
+                             FilterIO{.filters = make_filters(std::chrono::days(1), std::nullopt, std::nullopt, std::nullopt, std::nullopt), .search = "a", .output{}},
+                             FilterIO{.filters = make_filters(std::chrono::days(1), std::nullopt, std::nullopt, std::nullopt, std::nullopt), .search = "n", .output{"b/new"}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, std::nullopt, std::nullopt, getuid() + 1), .search = "b", .output{}},
+                             // Erasing a pattern lists every folder again
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, std::nullopt, std::nullopt, std::nullopt), .search = "b\b", .output{"a", "a/old", "a/old/deep", "b", "b/new", "c"}, .commands{parser::Command::GLOB}},
+                             FilterIO{.filters = make_filters(std::nullopt, 2, std::nullopt, std::nullopt, std::nullopt), .search = "b\b", .output{"a/old", "a/old/deep", "b/new"}, .commands{parser::Command::REGEX}},
+                             // Trigram candidates are masked by the filters as well
+                             FilterIO{.filters = make_filters(std::nullopt, 3, std::nullopt, std::nullopt, std::nullopt), .search = "'old", .output{"a/old/deep"}, .commands{parser::Command::TRIGRAM}},
+                             FilterIO{.filters = make_filters(std::nullopt, std::nullopt, 2, std::nullopt, std::nullopt), .search = "'old", .output{"a/old"}, .commands{parser::Command::TRIGRAM}},
+                             FilterIO{.filters = make_filters(std::nullopt, 2, std::nullopt, std::nullopt, std::nullopt), .search = "'new", .output{"b/new"}, .commands{parser::Command::TRIGRAM}}));
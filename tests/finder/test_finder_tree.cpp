@@ -0,0 +1,251 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+import finder;
+import parser;
+import query;
+import tui;
+import vfs;
+
+namespace
+{
+/**
+ * Row as drawn, copied out of the finder
+ */
+struct Drawn
+{
+    std::string text;
+    bool nested{false};
+    size_t depth{0};
+    size_t count{0};
+    tui::Branch branch{tui::Branch::LEAF};
+};
+
+/**
+ * Deterministic tree with short names so single letters match at every level
+ */
+vfs::Shape shape()
+{
+    constexpr size_t FANOUT{3};
+    constexpr size_t DEPTH{4};
+    constexpr size_t MAX_NAME{3};
+    return {.min_fanout = FANOUT, .max_fanout = FANOUT, .depth = DEPTH, .min_name = 1, .max_name = MAX_NAME};
+}
+
+/**
+ * Lists the path of every folder of filesystem relative to its root
+ */
+std::vector<std::string> list_paths(const vfs::Synthetic& filesystem)
+{
+    std::vector<std::string> paths;
+    std::function<void(vfs::Synthetic::Handle, const std::string&)> list = [&](vfs::Synthetic::Handle directory, const std::string& prefix) {
+        filesystem.list(directory, "synthetic", [&](std::string_view name, bool /*symlink*/, vfs::Synthetic::Handle handle) {
+            paths.push_back(prefix + std::string(name));
+            list(handle, paths.back() + "/");
+        });
+    };
+    list(filesystem.open("synthetic"), "");
+    return paths;
+}
+} // namespace
+
+/**
+ * Tui backend keeping every drawn frame
+ */
+class TreeImpl
+{
+  public:
+    static void draw_input(const std::string& /*input*/)
+    {
+    }
+
+    static void draw_matches(size_t /*index*/, const std::vector<tui::Row>& rows, size_t /*matches*/, size_t /*total_folders*/)
+    {
+        std::vector<Drawn> frame;
+        for (const auto& row : rows)
+        {
+            frame.push_back({.text = std::string(row.text), .nested = row.nested, .depth = row.depth, .count = row.count, .branch = row.branch});
+        }
+        std::scoped_lock lock(mutex);
+        frames.push_back(std::move(frame));
+        drawn++;
+    }
+
+    [[nodiscard]] static size_t rows()
+    {
+        constexpr size_t ROWS{1000};
+        return ROWS;
+    }
+
+    [[nodiscard]] static int get_input()
+    {
+        return 0;
+    }
+
+    static inline std::mutex mutex;                       /// NOLINT
+    static inline std::vector<std::vector<Drawn>> frames; /// NOLINT
+    static inline std::atomic<size_t> drawn{0};           /// NOLINT
+};
+
+/**
+ * Testclass checking the tree view against counts and folding computed from scratch
+ */
+class TestFinderTree : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        std::scoped_lock lock(TreeImpl::mutex);
+        TreeImpl::frames.clear();
+        TreeImpl::drawn = 0;
+    }
+
+    /**
+     * Retrieves the last drawn frame
+     */
+    static std::vector<Drawn> last_frame()
+    {
+        std::scoped_lock lock(TreeImpl::mutex);
+        return TreeImpl::frames.back();
+    }
+
+    /**
+     * Checks every row of frame against the folders matching search.
+     * Counts are recounted over all paths, the visible rows are listed depth first
+     * through the folders drawn as expanded.
+     */
+    static void check(const std::vector<Drawn>& frame, const std::vector<std::string>& paths, std::string_view search)
+    {
+        query::Plan plan;
+        plan.parse(search);
+        std::vector<std::string> matches;
+        std::ranges::copy_if(paths, std::back_inserter(matches), [&](const std::string& path) { return plan.matches(path); });
+        auto below = [&](const std::string& folder) {
+            return static_cast<size_t>(std::ranges::count_if(matches, [&](const std::string& match) { return match.starts_with(folder + "/"); }));
+        };
+
+        std::map<std::string, tui::Branch> branches;
+        for (const auto& row : frame)
+        {
+            auto count = below(row.text);
+            EXPECT_TRUE(row.nested) << row.text;
+            EXPECT_EQ(row.depth, static_cast<size_t>(std::ranges::count(row.text, '/'))) << row.text;
+            EXPECT_EQ(row.count, count) << "Incremental count differs from recount of " << row.text << " for search " << search;
+            EXPECT_EQ(row.branch == tui::Branch::LEAF, count == 0) << row.text;
+            branches[row.text] = row.branch;
+        }
+
+        std::vector<std::string> expected;
+        std::function<void(const std::string&)> flatten = [&](const std::string& prefix) {
+            for (const auto& path : paths)
+            {
+                if (!path.starts_with(prefix) || path.find('/', prefix.size()) != std::string::npos)
+                {
+                    continue;
+                }
+                if (std::ranges::find(matches, path) == matches.end() && below(path) == 0)
+                {
+                    continue;
+                }
+                expected.push_back(path);
+                if (auto branch = branches.find(path); branch != branches.end() && branch->second == tui::Branch::EXPANDED)
+                {
+                    flatten(path + "/");
+                }
+            }
+        };
+        flatten("");
+        std::vector<std::string> visible;
+        std::ranges::transform(frame, std::back_inserter(visible), &Drawn::text);
+        EXPECT_EQ(visible, expected) << "Visible folders differ from a fresh flatten for search " << search;
+    }
+};
+
+/**
+ * Typing, deleting, moving and folding keep the counts equal to a recount
+ */
+TEST_F(TestFinderTree, testCountsMatchRecount)
+{
+    vfs::Synthetic filesystem(shape());
+    auto paths = list_paths(filesystem);
+    std::ranges::sort(paths);
+    tui::Tui<TreeImpl> tui;
+    finder::Finder finder(std::move(filesystem), tui, "synthetic", {parser::Command::TREE});
+    while (!finder.indexed())
+    {
+        std::this_thread::yield();
+    }
+    check(last_frame(), paths, "");
+
+    // Letters are typed, '\b' deletes, '+'/'-' move and '>'/'<' expand and collapse the selection
+    std::string search;
+    for (auto key : std::string_view(">+>+>-<<a>+>++>b\b\bc+>d\b\b<-<e>f+>\bg\b\b"))
+    {
+        auto drawn = TreeImpl::drawn.load();
+        if (key == '+' || key == '-')
+        {
+            finder.update_index(key == '+' ? 1 : -1);
+        }
+        else if (key == '>' || key == '<')
+        {
+            finder.update_fold(key == '>' ? parser::Toggle::EXPAND : parser::Toggle::COLLAPSE);
+        }
+        else
+        {
+            finder.update_search(key == '\b' ? '\0' : key, tui);
+            if (key == '\b')
+            {
+                search.pop_back();
+            }
+            else
+            {
+                search.push_back(key);
+            }
+        }
+        while (TreeImpl::drawn == drawn)
+        {
+            std::this_thread::yield();
+        }
+        check(last_frame(), paths, search);
+    }
+}
+
+/**
+ * Frames drawn while walking list full paths since the tree is only known afterwards
+ */
+TEST_F(TestFinderTree, testProgressShowsPaths)
+{
+    constexpr auto LATENCY = std::chrono::milliseconds(2);
+    auto slow = shape();
+    slow.latency = LATENCY;
+    tui::Tui<TreeImpl> tui;
+    finder::Finder finder(vfs::Synthetic(slow), tui, "synthetic", {parser::Command::TREE});
+    while (!finder.indexed())
+    {
+        std::this_thread::yield();
+    }
+
+    std::scoped_lock lock(TreeImpl::mutex);
+    ASSERT_GE(TreeImpl::frames.size(), 2) << "No frame was drawn while walking";
+    bool nested_path{false};
+    for (size_t frame = 0; frame + 1 < TreeImpl::frames.size(); frame++)
+    {
+        for (const auto& row : TreeImpl::frames[frame])
+        {
+            EXPECT_FALSE(row.nested) << row.text;
+            nested_path |= row.text.find('/') != std::string::npos;
+        }
+    }
+    EXPECT_TRUE(nested_path) << "No folder below the top level was drawn while walking";
+    EXPECT_TRUE(TreeImpl::frames.back().front().nested);
+}
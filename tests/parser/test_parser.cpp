@@ -1,6 +1,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include <chrono>
 #include <filesystem>
 #include <map>
 #include <optional>
@@ -18,7 +19,7 @@ import tui;
 struct InputIO
 {
     int input{};
-    std::optional<std::variant<char, bool, int>> output;
+    std::optional<std::variant<char, bool, int, parser::Toggle>> output;
 };
 
 /**
@@ -86,6 +87,14 @@ INSTANTIATE_TEST_SUITE_P(SweepGetInput,
                                  .input = 353, // Shift+Tab
                                  .output = -1,
                              },
+                             InputIO{
+                                 .input = 260, // Arrow Left
+                                 .output = parser::Toggle::COLLAPSE,
+                             },
+                             InputIO{
+                                 .input = 261, // Arrow Right
+                                 .output = parser::Toggle::EXPAND,
+                             },
                              InputIO{
                                  .input = 263, // Backspace
                                  .output = '\0',
@@ -93,6 +102,14 @@ INSTANTIATE_TEST_SUITE_P(SweepGetInput,
                              InputIO{
                                  .input = 'h', // Some Letter
                                  .output = 'h',
+                             },
+                             InputIO{
+                                 .input = 0xC3, // First byte of a two byte UTF-8 character
+                                 .output = static_cast<char>(0xC3),
+                             },
+                             InputIO{
+                                 .input = 127, // Delete control character
+                                 .output = std::nullopt,
                              }));
 
 /**
@@ -103,6 +120,8 @@ struct ArgsIO
     std::vector<const char*> args;
     std::filesystem::path path;
     std::vector<parser::Command> commands;
+    std::filesystem::path record;
+    parser::Filters filters;
 };
 
 /**
@@ -127,6 +146,29 @@ class TestGetArgs : public testing::TestWithParam<ArgsIO>
         return args_string;
     }
 
+    /**
+     * Retrieves the command of a flag taking a value among the last two args
+     */
+    static std::optional<parser::Command> valuedCommand(const std::vector<const char*>& args)
+    {
+        static std::map<std::string, parser::Command> valued{
+            {"-r", parser::Command::RECORD},
+            {"--changed-within", parser::Command::CHANGED},
+            {"--min-depth", parser::Command::MIN_DEPTH},
+            {"--max-depth", parser::Command::MAX_DEPTH},
+            {"--min-entries", parser::Command::MIN_ENTRIES},
+            {"--owner", parser::Command::OWNER},
+        };
+        for (auto arg = args.rbegin(); arg != args.rend() && arg != args.rbegin() + 2; arg++)
+        {
+            if (auto iter = valued.find(*arg); iter != valued.end())
+            {
+                return iter->second;
+            }
+        }
+        return std::nullopt;
+    }
+
     static std::string commandsToString(const std::vector<parser::Command>& cmds)
     {
         static std::map<parser::Command, std::string> cmd_to_string{
@@ -135,6 +177,18 @@ class TestGetArgs : public testing::TestWithParam<ArgsIO>
             {parser::Command::PATH, "Command::PATH"},
             {parser::Command::ICASE, "Command::ICASE"},
             {parser::Command::FPATH, "Command::FPATH"},
+            {parser::Command::TRIGRAM, "Command::TRIGRAM"},
+            {parser::Command::COMPACT, "Command::COMPACT"},
+            {parser::Command::PREVIEW, "Command::PREVIEW"},
+            {parser::Command::RECORD, "Command::RECORD"},
+            {parser::Command::GLOB, "Command::GLOB"},
+            {parser::Command::REGEX, "Command::REGEX"},
+            {parser::Command::CHANGED, "Command::CHANGED"},
+            {parser::Command::MIN_DEPTH, "Command::MIN_DEPTH"},
+            {parser::Command::MAX_DEPTH, "Command::MAX_DEPTH"},
+            {parser::Command::MIN_ENTRIES, "Command::MIN_ENTRIES"},
+            {parser::Command::OWNER, "Command::OWNER"},
+            {parser::Command::TREE, "Command::TREE"},
         };
 
         std::string cmds_string("[");
@@ -157,7 +211,7 @@ class TestGetArgs : public testing::TestWithParam<ArgsIO>
  */
 TEST_P(TestGetArgs, testGetArgs)
 {
-    auto [args, path, commands] = GetParam();
+    auto [args, path, commands, record, filters] = GetParam();
 
     try
     {
@@ -177,6 +231,12 @@ TEST_P(TestGetArgs, testGetArgs)
                                           << "\n"
                                              "Provided args: "
                                           << argsToString(args);
+        EXPECT_EQ(out.record, record) << "Expected record file does not match parsed record file\n"
+                                         "Provided args: "
+                                      << argsToString(args);
+        EXPECT_EQ(out.filters, filters) << "Expected filters don't match parsed filters\n"
+                                           "Provided args: "
+                                        << argsToString(args);
     }
     catch (parser::CmdExcept& except)
     {
@@ -190,6 +250,12 @@ TEST_P(TestGetArgs, testGetArgs)
             EXPECT_EQ(except.type(), parser::Command::HELP) << "Flag -h was provided\n"
                                                                "Expected exception type: Command::HELP";
         }
+        else if (auto valued = valuedCommand(args))
+        {
+            EXPECT_EQ(except.type(), *valued) << "Flag was provided without a valid value\n"
+                                                 "Expected exception type: "
+                                              << commandsToString({*valued});
+        }
         else
         {
             EXPECT_EQ(except.type(), parser::Command::UKNOWN) << "Got exception and -h flag was not present\n"
@@ -214,19 +280,111 @@ INSTANTIATE_TEST_SUITE_P(SweetGetArgs,
                                  .args{"fzf-folder", "."},
                                  .path{std::filesystem::path(".")},
                                  .commands{},
+                                 .record{},
+                                 .filters{},
                              },
                              ArgsIO{
                                  .args = {"fzf-folder", "-i", "-f"},
                                  .path{std::filesystem::current_path()},
                                  .commands{parser::Command::ICASE, parser::Command::FPATH},
+                                 .record{},
+                                 .filters{},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--tree", "-p"},
+                                 .path{std::filesystem::current_path()},
+                                 .commands{parser::Command::TREE, parser::Command::PREVIEW},
+                                 .record{},
+                                 .filters{},
                              },
                              ArgsIO{
                                  .args = {"fzf-folder", "-h"},
                                  .path{},
                                  .commands{},
+                                 .record{},
+                                 .filters{},
                              },
                              ArgsIO{
                                  .args = {"fzf-folder", "random-unkown-command"},
                                  .path{},
                                  .commands{},
+                                 .record{},
+                                 .filters{},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "-r", "session.keys", "-f"},
+                                 .path{std::filesystem::current_path()},
+                                 .commands{parser::Command::FPATH},
+                                 .record{"session.keys"},
+                                 .filters{},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "-r"},
+                                 .path{},
+                                 .commands{},
+                                 .record{},
+                                 .filters{},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--changed-within", "2d", "--min-depth", "1", "--max-depth", "3", "--min-entries", "5", "--owner", "0"},
+                                 .path{std::filesystem::current_path()},
+                                 .commands{},
+                                 .record{},
+                                 .filters{.changed_within = std::chrono::hours(48), .min_depth = 1, .max_depth = 3, .min_entries = 5, .owner = 0},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--min-depth", "two"},
+                                 .path{},
+                                 .commands{},
+                                 .record{},
+                                 .filters{},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--changed-within", "2y"},
+                                 .path{},
+                                 .commands{},
+                                 .record{},
+                                 .filters{},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--changed-within", "15250284452472w"}, // Overflows seconds
+                                 .path{},
+                                 .commands{},
+                                 .record{},
+                                 .filters{},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--changed-within", "15250284452471w"},
+                                 .path{std::filesystem::current_path()},
+                                 .commands{},
+                                 .record{},
+                                 .filters{.changed_within = std::chrono::weeks(15250284452471), .min_depth = std::nullopt, .max_depth = std::nullopt, .min_entries = std::nullopt, .owner = std::nullopt},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--owner", "4294967296"}, // Above UINT32_MAX
+                                 .path{},
+                                 .commands{},
+                                 .record{},
+                                 .filters{},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--owner", "4294967295"}, // Marks folders without a known owner
+                                 .path{},
+                                 .commands{},
+                                 .record{},
+                                 .filters{},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--owner", "4294967294"},
+                                 .path{std::filesystem::current_path()},
+                                 .commands{},
+                                 .record{},
+                                 .filters{.changed_within = std::nullopt, .min_depth = std::nullopt, .max_depth = std::nullopt, .min_entries = std::nullopt, .owner = 4294967294},
+                             },
+                             ArgsIO{
+                                 .args = {"fzf-folder", "--min-entries", "-1"},
+                                 .path{},
+                                 .commands{},
+                                 .record{},
+                                 .filters{},
                              }));
@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+import pattern;
+
+/**
+ * Struct representing IO for Automaton::matches
+ */
+struct MatchIO
+{
+    pattern::Syntax syntax{pattern::Syntax::GLOB};
+    std::string_view pattern;
+    std::string_view path;
+    bool output{false};
+};
+
+/**
+ * Testclass for testing compiled patterns against paths
+ */
+class TestPatternMatch : public testing::TestWithParam<MatchIO>
+{
+};
+
+/**
+ * Parameterized test checking if a pattern matches a path
+ */
+TEST_P(TestPatternMatch, testMatches)
+{
+    auto [syntax, pattern, path, output] = GetParam();
+    pattern::Automaton automaton(syntax);
+
+    ASSERT_TRUE(automaton.compile(pattern));
+
+    EXPECT_EQ(automaton.matches(path), output) << pattern << " on " << path;
+}
+
+/**
+ * Pattern, path and whether the pattern matches it
+ */
+INSTANTIATE_TEST_SUITE_P(SweepMatches,
+                         TestPatternMatch,
+                         testing::Values(
+                             // Empty patterns match every path
+                             MatchIO{.pattern = "", .path = "src/core", .output = true},
+                             MatchIO{.pattern = "", .path = "", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "", .path = "src/core", .output = true},
+                             // Globs match the whole path
+                             MatchIO{.pattern = "src", .path = "src", .output = true},
+                             MatchIO{.pattern = "src", .path = "src/core", .output = false},
+                             MatchIO{.pattern = "core", .path = "src/core", .output = false},
+                             MatchIO{.pattern = "src/*", .path = "src/core", .output = true},
+                             MatchIO{.pattern = "src/*", .path = "src/core/unit", .output = false},
+                             MatchIO{.pattern = "src/**", .path = "src/core/unit", .output = true},
+                             MatchIO{.pattern = "**/core", .path = "core", .output = true},
+                             MatchIO{.pattern = "**/core", .path = "a/b/core", .output = true},
+                             MatchIO{.pattern = "**/core", .path = "a/b/core/unit", .output = false},
+                             MatchIO{.pattern = "a/**/core", .path = "a/core", .output = true},
+                             MatchIO{.pattern = "a/**/core", .path = "a/b/c/core", .output = true},
+                             MatchIO{.pattern = "*core", .path = "src/core", .output = false},
+                             MatchIO{.pattern = "src/c?re", .path = "src/core", .output = true},
+                             MatchIO{.pattern = "src?core", .path = "src/core", .output = false},
+                             MatchIO{.pattern = "caf?", .path = "café", .output = true},
+                             MatchIO{.pattern = "caf??", .path = "café", .output = false},
+                             MatchIO{.pattern = "\\*", .path = "*", .output = true},
+                             // Glob classes stay within a folder name
+                             MatchIO{.pattern = "v[0-9]", .path = "v7", .output = true},
+                             MatchIO{.pattern = "v[0-9]", .path = "vx", .output = false},
+                             MatchIO{.pattern = "v[!0-9]", .path = "vx", .output = true},
+                             MatchIO{.pattern = "v[!0-9]", .path = "v7", .output = false},
+                             MatchIO{.pattern = "v[!0-9]", .path = "v/", .output = false},
+                             MatchIO{.pattern = "v[!0-9]", .path = "vé", .output = true},
+                             MatchIO{.pattern = "[]]", .path = "]", .output = true},
+                             // Regexes match anywhere unless anchored
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "core", .path = "src/core/unit", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^core", .path = "src/core", .output = false},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "core$", .path = "src/core", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "core$", .path = "src/core/unit", .output = false},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "core\\$", .path = "core$", .output = true},
+                             // Regex alternation and repetition
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^src/(core|tui)$", .path = "src/tui", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^src/(core|tui)$", .path = "src/cli", .output = false},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "build|cache", .path = "a/cache", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^a(b|cd)*e$", .path = "abcdbe", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^a(b|cd)*e$", .path = "abce", .output = false},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^ab+c?$", .path = "abbb", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^ab+c?$", .path = "ac", .output = false},
+                             // Regex classes
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "v\\d\\d", .path = "v10", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "v\\d\\d", .path = "v1x", .output = false},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^\\w+$", .path = "snake_case1", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^\\w+$", .path = "a-b", .output = false},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "a\\sb", .path = "a b", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^[^/]+$", .path = "src", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^[^/]+$", .path = "src/core", .output = false},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^caf.$", .path = "café", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^caf[^x]$", .path = "café", .output = true},
+                             MatchIO{.syntax = pattern::Syntax::REGEX, .pattern = "^caf..$", .path = "café", .output = false}));
+
+/**
+ * Malformed patterns fail to compile and match nothing
+ */
+TEST(TestPattern, testMalformed)
+{
+    pattern::Automaton regex(pattern::Syntax::REGEX);
+    for (const auto* malformed : {"(core", "core)", "*core", "a|+", "[core", "core\\"})
+    {
+        EXPECT_FALSE(regex.compile(malformed)) << malformed;
+        EXPECT_FALSE(regex.matches(malformed)) << malformed;
+    }
+}
+
+/**
+ * More DFA states than MAX_STATES are needed to tell which of the last bytes were an a,
+ * matching must stay correct while the cache is flushed and rebuilt
+ */
+TEST(TestPattern, testCacheFlush)
+{
+    constexpr size_t DISTANCE{10};
+    constexpr size_t LENGTH{14};
+    static_assert(size_t{1} << DISTANCE > pattern::Automaton::MAX_STATES);
+
+    pattern::Automaton regex(pattern::Syntax::REGEX);
+    std::string expression("a");
+    for (size_t byte = 1; byte < DISTANCE; byte++)
+    {
+        expression += "[ab]";
+    }
+    ASSERT_TRUE(regex.compile(expression + "$"));
+
+    std::string path(LENGTH, 'b');
+    for (size_t bits = 0; bits < size_t{1} << LENGTH; bits++)
+    {
+        for (size_t byte = 0; byte < LENGTH; byte++)
+        {
+            path[byte] = (bits >> byte & 1) != 0 ? 'a' : 'b';
+        }
+        EXPECT_EQ(regex.matches(path), path[LENGTH - DISTANCE] == 'a') << path;
+    }
+}
+
+/**
+ * Struct representing IO for Automaton::highlight
+ */
+struct HighlightIO
+{
+    pattern::Syntax syntax{pattern::Syntax::REGEX};
+    std::string_view pattern;
+    std::string_view path;
+    size_t begin{0};
+    size_t length{0};
+};
+
+/**
+ * Testclass for testing highlight spans
+ */
+class TestPatternHighlight : public testing::TestWithParam<HighlightIO>
+{
+  protected:
+    struct Span
+    {
+        size_t begin{0};
+        size_t length{0};
+    };
+};
+
+/**
+ * Parameterized test checking the leftmost longest match, no span if the match is empty
+ */
+TEST_P(TestPatternHighlight, testHighlight)
+{
+    auto [syntax, pattern, path, begin, length] = GetParam();
+    pattern::Automaton automaton(syntax);
+    ASSERT_TRUE(automaton.compile(pattern));
+
+    std::vector<Span> spans;
+    automaton.highlight(path, spans);
+
+    if (length == 0)
+    {
+        EXPECT_TRUE(spans.empty());
+        return;
+    }
+    ASSERT_EQ(spans.size(), 1);
+    EXPECT_EQ(spans.front().begin, begin);
+    EXPECT_EQ(spans.front().length, length);
+}
+
+/**
+ * Pattern, path and the expected highlighted range
+ */
+INSTANTIATE_TEST_SUITE_P(SweepHighlight,
+                         TestPatternHighlight,
+                         testing::Values(HighlightIO{.pattern = "co.e", .path = "src/core/code", .begin = 4, .length = 4},
+                                         HighlightIO{.pattern = "a+", .path = "baaab", .begin = 1, .length = 3},
+                                         HighlightIO{.pattern = "a|ab", .path = "xab", .begin = 1, .length = 2},
+                                         HighlightIO{.pattern = "core$", .path = "core/core", .begin = 5, .length = 4},
+                                         HighlightIO{.pattern = "^src", .path = "src/src", .begin = 0, .length = 3},
+                                         HighlightIO{.pattern = "caf.", .path = "café", .begin = 0, .length = 5},
+                                         HighlightIO{.pattern = "x*", .path = "abc", .begin = 0, .length = 0},
+                                         HighlightIO{.syntax = pattern::Syntax::GLOB, .pattern = "", .path = "abc", .begin = 0, .length = 0},
+                                         HighlightIO{.syntax = pattern::Syntax::GLOB, .pattern = "**/c*", .path = "src/core", .begin = 0, .length = 8}));
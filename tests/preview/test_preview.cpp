@@ -0,0 +1,126 @@
+
+#include "alloc_counter.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+import preview;
+
+/**
+ * Testclass for the directory listing prefetcher
+ */
+class TestPrefetcher : public testing::Test
+{
+  protected:
+    static constexpr size_t ENTRIES{600};
+
+    void SetUp() override
+    {
+        m_root = std::filesystem::temp_directory_path() / ("fzf-folder-preview-" + std::to_string(getpid()));
+        std::filesystem::create_directories(m_root / "small" / "sub");
+        std::ofstream(m_root / "small" / "file");
+        // A symlink to itself can't be statted, the folders around it must still be listed
+        for (const auto* name : {"a", "b", "c", "x", "y", "z"})
+        {
+            std::filesystem::create_directories(m_root / "loop" / name);
+        }
+        std::filesystem::create_symlink("self", m_root / "loop" / "self");
+        // Names are created out of alphabetical order so directory order differs from it
+        for (size_t entry = 0; entry < ENTRIES; entry++)
+        {
+            auto name = std::to_string((entry * 7919) % ENTRIES + 1000);
+            std::filesystem::create_directories(m_root / "large" / name);
+        }
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_root);
+    }
+
+    /**
+     * Requests folder and waits until its listing is cached
+     */
+    static std::shared_ptr<const preview::Listing> fetch(preview::Prefetcher& prefetcher, std::string_view folder)
+    {
+        std::array<std::string_view, 1> folders{folder};
+        prefetcher.request(folders);
+        while (true)
+        {
+            if (auto listing = prefetcher.get(folder))
+            {
+                return listing;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    std::filesystem::path m_root;
+};
+
+/**
+ * Small directories are listed in full and in order, directories end with '/'
+ */
+TEST_F(TestPrefetcher, testListsSmallDirectory)
+{
+    preview::Prefetcher prefetcher(m_root, [](std::string_view /*folder*/) {});
+    auto listing = fetch(prefetcher, "small");
+    EXPECT_EQ(*listing, (preview::Listing{"file", "sub/"}));
+}
+
+/**
+ * Entries that fail to stat are listed as files without ending the listing
+ */
+TEST_F(TestPrefetcher, testListsPastUnstattableEntries)
+{
+    preview::Prefetcher prefetcher(m_root, [](std::string_view /*folder*/) {});
+    auto listing = fetch(prefetcher, "loop");
+    EXPECT_EQ(*listing, (preview::Listing{"a/", "b/", "c/", "self", "x/", "y/", "z/"}));
+}
+
+/**
+ * Large directories show their alphabetically first entries followed by the number left out
+ */
+TEST_F(TestPrefetcher, testTruncatesLargeDirectoryAfterSorting)
+{
+    preview::Prefetcher prefetcher(m_root, [](std::string_view /*folder*/) {});
+    auto listing = fetch(prefetcher, "large");
+
+    preview::Listing expected;
+    for (size_t entry = 0; entry < preview::Prefetcher::MAX_ENTRIES; entry++)
+    {
+        expected.push_back(std::to_string(entry + 1000) + "/");
+    }
+    expected.push_back("... " + std::to_string(ENTRIES - preview::Prefetcher::MAX_ENTRIES) + " more");
+    EXPECT_EQ(*listing, expected);
+}
+
+/**
+ * Requests and lookups are made while drawing frames and must not allocate
+ */
+TEST_F(TestPrefetcher, testRequestsDontAllocate)
+{
+    preview::Prefetcher prefetcher(m_root, [](std::string_view /*folder*/) {});
+    (void)fetch(prefetcher, "small");
+    std::array<std::string_view, preview::Prefetcher::MAX_REQUESTS> folders{"small/sub", "small", "large"};
+
+    // Only this thread draws frames, the prefetch thread allocates listings
+    stubAlloc::start_counting(stubAlloc::Threads::CALLING);
+    for (size_t frame = 0; frame < 1000; frame++)
+    {
+        std::ranges::rotate(folders, folders.begin() + 1);
+        prefetcher.request(folders);
+        (void)prefetcher.get(folders.front());
+    }
+    auto allocations = stubAlloc::stop_counting();
+
+    EXPECT_EQ(allocations, 0) << "Heap allocations while requesting listings";
+}
@@ -0,0 +1,275 @@
+#include "gtest/gtest.h"
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+import query;
+
+namespace
+{
+/**
+ * Writes term back in query syntax, exact negated terms keep their quote, e.g. !'tmp
+ */
+std::string render(const query::Term& term)
+{
+    std::string text(term.negate ? "!" : "");
+    switch (term.kind)
+    {
+    case query::Kind::FUZZY:
+        return text + std::string(term.text);
+    case query::Kind::EXACT:
+        return text + "'" + std::string(term.text);
+    case query::Kind::PREFIX:
+        return text + "^" + std::string(term.text);
+    case query::Kind::SUFFIX:
+        return text + std::string(term.text) + "$";
+    case query::Kind::EQUAL:
+        return text + "^" + std::string(term.text) + "$";
+    }
+    return text;
+}
+} // namespace
+
+/**
+ * Struct representing IO for Plan::parse
+ */
+struct ParseIO
+{
+    std::string_view search;
+    std::vector<std::vector<std::string>> clauses;
+};
+
+/**
+ * Testclass for testing parsed terms and clause order
+ */
+class TestQueryParse : public testing::TestWithParam<ParseIO>
+{
+};
+
+/**
+ * Parameterized test checking the alternatives of every clause in evaluation order
+ */
+TEST_P(TestQueryParse, testParse)
+{
+    auto [search, clauses] = GetParam();
+    query::Plan plan;
+
+    plan.parse(search);
+
+    std::vector<std::vector<std::string>> parsed;
+    plan.for_each_clause([&](std::span<const query::Term> terms) {
+        auto& clause = parsed.emplace_back();
+        for (const auto& term : terms)
+        {
+            clause.push_back(render(term));
+        }
+    });
+    EXPECT_EQ(parsed, clauses) << "Search: " << search;
+    EXPECT_EQ(plan.empty(), clauses.empty()) << "Search: " << search;
+}
+
+/**
+ * Search and its clauses, cheapest first
+ */
+INSTANTIATE_TEST_SUITE_P(SweepParse,
+                         TestQueryParse,
+                         testing::Values(
+                             // Term kinds
+                             ParseIO{.search = "", .clauses{}},
+                             ParseIO{.search = "src", .clauses{{"src"}}},
+                             ParseIO{.search = "'src", .clauses{{"'src"}}},
+                             ParseIO{.search = "^src", .clauses{{"^src"}}},
+                             ParseIO{.search = "src$", .clauses{{"src$"}}},
+                             ParseIO{.search = "^src$", .clauses{{"^src$"}}},
+                             ParseIO{.search = "!tmp", .clauses{{"!'tmp"}}},
+                             ParseIO{.search = "!^tmp", .clauses{{"!^tmp"}}},
+                             ParseIO{.search = "!tmp$", .clauses{{"!tmp$"}}},
+                             // Markers without text
+                             ParseIO{.search = "$", .clauses{{"$"}}},
+                             ParseIO{.search = "' ^ !", .clauses{}},
+                             ParseIO{.search = "a  b", .clauses{{"a"}, {"b"}}},
+                             // Alternatives
+                             ParseIO{.search = "a | b", .clauses{{"a", "b"}}},
+                             ParseIO{.search = "a | b | 'c", .clauses{{"a", "b", "'c"}}},
+                             ParseIO{.search = "| a", .clauses{{"a"}}},
+                             ParseIO{.search = "a |", .clauses{{"a"}}},
+                             ParseIO{.search = "a | | b", .clauses{{"a", "b"}}},
+                             ParseIO{.search = "a|b", .clauses{{"a|b"}}},
+                             // Anchored, exact, negated and fuzzy clauses run in that order
+                             ParseIO{.search = "fuzzy !neg 'exact ^pre", .clauses{{"^pre"}, {"'exact"}, {"!'neg"}, {"fuzzy"}}},
+                             ParseIO{.search = "'ab 'abcd", .clauses{{"'abcd"}, {"'ab"}}},
+                             ParseIO{.search = "'ab 'cd", .clauses{{"'ab"}, {"'cd"}}},
+                             ParseIO{.search = "^a | b 'c", .clauses{{"'c"}, {"^a", "b"}}}));
+
+/**
+ * Struct representing IO for Plan::matches
+ */
+struct MatchIO
+{
+    std::string_view search;
+    std::string_view path;
+    bool output{false};
+};
+
+/**
+ * Testclass for testing which paths a plan accepts
+ */
+class TestQueryMatch : public testing::TestWithParam<MatchIO>
+{
+};
+
+/**
+ * Parameterized test checking if a search matches a path
+ */
+TEST_P(TestQueryMatch, testMatches)
+{
+    auto [search, path, output] = GetParam();
+    query::Plan plan;
+
+    plan.parse(search);
+
+    EXPECT_EQ(plan.matches(path), output) << search << " on " << path;
+}
+
+/**
+ * Search, path and whether the search matches it
+ */
+INSTANTIATE_TEST_SUITE_P(SweepMatches,
+                         TestQueryMatch,
+                         testing::Values(MatchIO{.search = "", .path = "src", .output = true},
+                                         MatchIO{.search = "sc", .path = "src", .output = true},
+                                         MatchIO{.search = "cs", .path = "src", .output = false},
+                                         MatchIO{.search = "ss", .path = "src", .output = false},
+                                         MatchIO{.search = "c\xC3\xA9", .path = "caf\xC3\xA9", .output = true},
+                                         MatchIO{.search = "'rc", .path = "src", .output = true},
+                                         MatchIO{.search = "'sc", .path = "src", .output = false},
+                                         MatchIO{.search = "^src", .path = "src/core", .output = true},
+                                         MatchIO{.search = "^core", .path = "src/core", .output = false},
+                                         MatchIO{.search = "core$", .path = "src/core", .output = true},
+                                         MatchIO{.search = "src$", .path = "src/core", .output = false},
+                                         MatchIO{.search = "^src$", .path = "src", .output = true},
+                                         MatchIO{.search = "^src$", .path = "src/core", .output = false},
+                                         MatchIO{.search = "!tmp", .path = "src", .output = true},
+                                         MatchIO{.search = "!tmp", .path = "a/tmp/b", .output = false},
+                                         MatchIO{.search = "!^tmp", .path = "a/tmp", .output = true},
+                                         MatchIO{.search = "!^tmp", .path = "tmp/a", .output = false},
+                                         MatchIO{.search = "a | z", .path = "xz", .output = true},
+                                         MatchIO{.search = "q | z", .path = "abc", .output = false},
+                                         MatchIO{.search = "s c", .path = "src", .output = true},
+                                         MatchIO{.search = "s q", .path = "src", .output = false},
+                                         MatchIO{.search = "^s | 'x c$", .path = "src", .output = true},
+                                         MatchIO{.search = "^s | 'x c$", .path = "srcs", .output = false}));
+
+/**
+ * Struct representing IO for Plan::literal
+ */
+struct LiteralIO
+{
+    std::string_view search;
+    std::string_view literal;
+};
+
+/**
+ * Testclass for testing the text usable for index lookups
+ */
+class TestQueryLiteral : public testing::TestWithParam<LiteralIO>
+{
+};
+
+/**
+ * Parameterized test checking the longest text every match contains
+ */
+TEST_P(TestQueryLiteral, testLiteral)
+{
+    auto [search, literal] = GetParam();
+    query::Plan plan;
+
+    plan.parse(search);
+
+    EXPECT_EQ(plan.literal(), literal) << "Search: " << search;
+}
+
+/**
+ * Search and its literal, only exact and anchored terms outside alternatives provide one
+ */
+INSTANTIATE_TEST_SUITE_P(SweepLiteral,
+                         TestQueryLiteral,
+                         testing::Values(LiteralIO{.search = "", .literal = ""},
+                                         LiteralIO{.search = "abcdef", .literal = ""},
+                                         LiteralIO{.search = "'abc", .literal = "abc"},
+                                         LiteralIO{.search = "^abc", .literal = "abc"},
+                                         LiteralIO{.search = "abc$", .literal = "abc"},
+                                         LiteralIO{.search = "'ab ^abcd fuzzyfuzzy", .literal = "abcd"},
+                                         LiteralIO{.search = "'abc | 'abcdef", .literal = ""},
+                                         LiteralIO{.search = "!'abcdef 'ab", .literal = "ab"}));
+
+/**
+ * Range of highlighted bytes
+ */
+struct Span
+{
+    size_t begin{0};
+    size_t length{0};
+
+    bool operator==(const Span&) const = default;
+};
+
+/**
+ * Struct representing IO for Plan::highlight
+ */
+struct HighlightIO
+{
+    std::string_view search;
+    std::string_view path;
+    std::vector<Span> spans;
+};
+
+/**
+ * Testclass for testing highlighted ranges
+ */
+class TestQueryHighlight : public testing::TestWithParam<HighlightIO>
+{
+};
+
+/**
+ * Parameterized test checking the merged spans appended after existing ones
+ */
+TEST_P(TestQueryHighlight, testHighlight)
+{
+    auto [search, path, spans] = GetParam();
+    query::Plan plan;
+    plan.parse(search);
+    // Spans of earlier rows are left untouched
+    std::vector<Span> out{{.begin = 7, .length = 1}};
+
+    plan.highlight(path, out);
+
+    ASSERT_FALSE(out.empty());
+    EXPECT_EQ(out.front(), (Span{.begin = 7, .length = 1}));
+    out.erase(out.begin());
+    ASSERT_EQ(out.size(), spans.size()) << search << " on " << path;
+    for (size_t span = 0; span < spans.size(); span++)
+    {
+        EXPECT_EQ(out[span].begin, spans[span].begin) << search << " on " << path;
+        EXPECT_EQ(out[span].length, spans[span].length) << search << " on " << path;
+    }
+}
+
+/**
+ * Search, matching path and the expected sorted spans
+ */
+INSTANTIATE_TEST_SUITE_P(SweepHighlight,
+                         TestQueryHighlight,
+                         testing::Values(HighlightIO{.search = "", .path = "src", .spans{}},
+                                         HighlightIO{.search = "sc", .path = "src", .spans{{.begin = 0, .length = 1}, {.begin = 2, .length = 1}}},
+                                         HighlightIO{.search = "sr", .path = "src", .spans{{.begin = 0, .length = 2}}},
+                                         HighlightIO{.search = "'rc", .path = "src", .spans{{.begin = 1, .length = 2}}},
+                                         HighlightIO{.search = "sr 'rc", .path = "src", .spans{{.begin = 0, .length = 3}}},
+                                         HighlightIO{.search = "core$ ^src", .path = "src/core", .spans{{.begin = 0, .length = 3}, {.begin = 4, .length = 4}}},
+                                         HighlightIO{.search = "^src$", .path = "src", .spans{{.begin = 0, .length = 3}}},
+                                         HighlightIO{.search = "!tmp a", .path = "a/b", .spans{{.begin = 0, .length = 1}}},
+                                         HighlightIO{.search = "z | 'b", .path = "a/b", .spans{{.begin = 2, .length = 1}}},
+                                         HighlightIO{.search = "'a | 'b", .path = "a/b", .spans{{.begin = 0, .length = 1}}},
+                                         HighlightIO{.search = "\xC3\xA9", .path = "caf\xC3\xA9", .spans{{.begin = 3, .length = 2}}}));
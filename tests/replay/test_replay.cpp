@@ -0,0 +1,248 @@
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+import stubTui;
+import finder;
+import parser;
+import tui;
+import unicode;
+import vfs;
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+/**
+ * Recorded key and the time since the previous key
+ */
+struct Key
+{
+    std::chrono::microseconds delay{};
+    int key{};
+};
+
+/**
+ * Reads a session recorded with fzf-folder -r <file>
+ * @param file session file
+ */
+std::vector<Key> load_session(const fs::path& file)
+{
+    std::vector<Key> keys;
+    std::ifstream stream(file);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.empty() || line.front() == '#')
+        {
+            continue;
+        }
+        std::istringstream fields(line);
+        long long delay{0};
+        Key key;
+        fields >> delay >> key.key;
+        key.delay = std::chrono::microseconds(delay);
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+/**
+ * Tracks the typed search like Finder to tell which keys draw a frame,
+ * bytes of a multi-byte UTF-8 character only draw once the character is complete
+ */
+class Typing
+{
+  public:
+    /**
+     * Checks if key makes the finder draw a new frame
+     * @param key recorded key
+     */
+    bool draws_frame(int key)
+    {
+        struct KeyTui
+        {
+            int key;
+            [[nodiscard]] int get_input() const
+            {
+                return key;
+            }
+        };
+        auto input = parser::get_input(KeyTui{key});
+        if (!input || std::holds_alternative<bool>(input.value()))
+        {
+            return false;
+        }
+        const auto* typed = std::get_if<char>(&input.value());
+        if (typed == nullptr)
+        {
+            return true;
+        }
+        if (*typed != 0)
+        {
+            m_search.push_back(*typed);
+            return unicode::complete(m_search);
+        }
+        while (!m_search.empty() && unicode::continuation(m_search.back()))
+        {
+            m_search.pop_back();
+        }
+        if (!m_search.empty())
+        {
+            m_search.pop_back();
+        }
+        return true;
+    }
+
+  private:
+    std::string m_search;
+};
+
+/**
+ * Deterministic in memory tree with FANOUT^1 + ... + FANOUT^DEPTH folders
+ */
+vfs::Synthetic generate_tree()
+{
+    constexpr size_t FANOUT{6};
+    constexpr size_t DEPTH{5};
+    constexpr size_t MIN_NAME{3};
+    constexpr size_t MAX_NAME{10};
+    return vfs::Synthetic({.min_fanout = FANOUT, .max_fanout = FANOUT, .depth = DEPTH, .min_name = MIN_NAME, .max_name = MAX_NAME});
+}
+} // namespace
+
+/**
+ * Testclass replaying recorded sessions against Finder through the mocked tui
+ */
+class TestReplay : public testing::TestWithParam<fs::path>
+{
+  private:
+    void SetUp() override
+    {
+        stubTui::MockImpl::create_mock();
+    }
+
+    void TearDown() override
+    {
+        stubTui::MockImpl::delete_mock();
+    }
+};
+
+/**
+ * Replays a session with its recorded timing and checks the p99 latency from
+ * a key being read to the resulting draw_matches call
+ */
+TEST_P(TestReplay, testLatency)
+{
+    constexpr int ESCAPE{27};
+    constexpr size_t ROWS{40};
+    auto keys = load_session(GetParam());
+    ASSERT_FALSE(keys.empty()) << "No keys in session " << GetParam();
+
+    std::mutex mutex;
+    std::vector<Clock::time_point> inputs;
+    std::vector<Clock::time_point> frames;
+    size_t total{0};
+    size_t next{0};
+    Typing typing;
+
+    auto* mock = stubTui::MockImpl::get_mock();
+    EXPECT_CALL(*mock, rows()).WillRepeatedly(testing::Return(ROWS));
+    EXPECT_CALL(*mock, draw_input(testing::_)).Times(testing::AnyNumber());
+    EXPECT_CALL(*mock, draw_matches(testing::_, testing::_, testing::_, testing::_)).WillRepeatedly([&](auto&& /*index*/, auto&& /*rows*/, auto&& /*matches*/, size_t total_folders) {
+        std::scoped_lock lock(mutex);
+        frames.push_back(Clock::now());
+        total = total_folders;
+    });
+    EXPECT_CALL(*mock, get_input()).WillRepeatedly([&] {
+        if (next == keys.size())
+        {
+            return ESCAPE;
+        }
+        std::this_thread::sleep_for(keys[next].delay);
+        auto key = keys[next++].key;
+        if (typing.draws_frame(key))
+        {
+            std::scoped_lock lock(mutex);
+            inputs.push_back(Clock::now());
+        }
+        return key;
+    });
+
+    tui::Tui<stubTui::MockImpl> tui;
+    auto filesystem = generate_tree();
+    auto folders = filesystem.size();
+    finder::Finder finder(std::move(filesystem), tui, "synthetic", {});
+    auto frames_drawn = [&](size_t count) {
+        constexpr auto TIMEOUT = std::chrono::seconds(10);
+        auto deadline = Clock::now() + TIMEOUT;
+        while (Clock::now() < deadline)
+        {
+            {
+                std::scoped_lock lock(mutex);
+                if (frames.size() >= count && finder.indexed())
+                {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    };
+    ASSERT_TRUE(frames_drawn(1)) << "Folders were never drawn";
+    EXPECT_EQ(total, folders) << "Not every generated folder was found";
+
+    // Frames drawn while walking precede the first key
+    size_t first_frame{0};
+    {
+        std::scoped_lock lock(mutex);
+        first_frame = frames.size();
+    }
+    finder::run(finder, tui);
+    ASSERT_TRUE(frames_drawn(first_frame + inputs.size())) << "Not every key resulted in a frame";
+
+    std::vector<long long> latencies;
+    {
+        std::scoped_lock lock(mutex);
+        for (size_t key = 0; key < inputs.size(); key++)
+        {
+            latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(frames[first_frame + key] - inputs[key]).count());
+        }
+    }
+    std::ranges::sort(latencies);
+    auto p99 = latencies[static_cast<size_t>(std::ceil(0.99 * static_cast<double>(latencies.size()))) - 1];
+    RecordProperty("p99_us", std::to_string(p99));
+    RecordProperty("max_us", std::to_string(latencies.back()));
+
+    EXPECT_LE(p99, REPLAY_P99_BUDGET_US) << "p99 latency from input to draw_matches exceeds budget\n"
+                                            "Session: "
+                                         << GetParam() << "\nKeys: " << latencies.size() << "\nMax latency: " << latencies.back() << "us";
+}
+
+/**
+ * Every recorded session in the sessions directory
+ */
+INSTANTIATE_TEST_SUITE_P(Sessions,
+                         TestReplay,
+                         testing::ValuesIn([] {
+                             std::vector<fs::path> sessions;
+                             for (const auto& entry : fs::directory_iterator(REPLAY_SESSIONS))
+                             {
+                                 sessions.push_back(entry.path());
+                             }
+                             std::ranges::sort(sessions);
+                             return sessions;
+                         }()),
+                         [](const testing::TestParamInfo<fs::path>& session) { return session.param.stem().string(); });
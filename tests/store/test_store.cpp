@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+import store;
+
+namespace
+{
+/**
+ * Paths per front coded block, the tests don't see the store's constant
+ */
+constexpr size_t BLOCK{16};
+
+/**
+ * Paths covering shared prefix edge cases, followed by enough deep paths to cross several block restarts
+ */
+std::vector<std::string> make_paths()
+{
+    constexpr size_t DEEP{70};
+    constexpr size_t LONG_NAME{200};
+    std::vector<std::string> paths{
+        "",           // Empty path first
+        "",           // Shared prefix with an empty path
+        "a",          //
+        "a",          // Whole path shared
+        "a/b",        // Previous path is a prefix
+        "a/bc",       //
+        "a/b",        // Shorter than the previous path and a prefix of it
+        "b",          // Nothing shared
+        "",           // Empty after a non empty path
+        "\xC3\xA9/x", // Multibyte characters
+        "\xC3\xA9/y", //
+    };
+    // Shared prefix and suffix lengths above 127 need two varint bytes
+    std::string deep = "alpha/" + std::string(LONG_NAME, 'x');
+    for (size_t path = 0; path < DEEP; path++)
+    {
+        paths.push_back(deep + "/" + std::to_string(path / 10) + "/" + std::to_string(path));
+    }
+    paths.push_back(deep + "/" + std::string(LONG_NAME, 'y'));
+    return paths;
+}
+} // namespace
+
+/**
+ * Testclass checking that stored paths read back unchanged, parameterized on compact mode
+ */
+class TestStore : public testing::TestWithParam<bool>
+{
+  protected:
+    void SetUp() override
+    {
+        m_paths = make_paths();
+        m_store = store::Store(GetParam());
+        for (const auto& path : m_paths)
+        {
+            m_store.push_back(path);
+        }
+        m_store.finalize();
+    }
+
+    std::vector<std::string> m_paths;
+    store::Store m_store;
+};
+
+/**
+ * Every path is retrieved by id, in reverse order so that no block is decoded ahead of time
+ */
+TEST_P(TestStore, testGet)
+{
+    ASSERT_EQ(m_store.size(), m_paths.size());
+    std::string buffer;
+    for (auto id = static_cast<uint32_t>(m_paths.size()); id-- > 0;)
+    {
+        EXPECT_EQ(m_store.get(id, buffer), m_paths[id]) << "Id: " << id;
+    }
+}
+
+/**
+ * Visiting every path yields them in order
+ */
+TEST_P(TestStore, testForEach)
+{
+    std::vector<std::pair<uint32_t, std::string>> visited;
+    m_store.for_each([&](uint32_t id, std::string_view path) { visited.emplace_back(id, path); });
+
+    ASSERT_EQ(visited.size(), m_paths.size());
+    for (uint32_t id = 0; id < visited.size(); id++)
+    {
+        EXPECT_EQ(visited[id].first, id);
+        EXPECT_EQ(visited[id].second, m_paths[id]) << "Id: " << id;
+    }
+}
+
+/**
+ * Plain and front coded storage
+ */
+INSTANTIATE_TEST_SUITE_P(SweepModes, TestStore, testing::Bool());
+
+/**
+ * Struct representing IO for visiting selected ids
+ */
+struct IdsIO
+{
+    std::vector<uint32_t> ids;
+};
+
+/**
+ * Testclass for visiting sorted id lists in both modes
+ */
+class TestStoreIds : public testing::TestWithParam<std::tuple<bool, IdsIO>>
+{
+};
+
+/**
+ * Parameterized test comparing the visited paths with the pushed ones
+ */
+TEST_P(TestStoreIds, testForEachIds)
+{
+    auto [compact, io] = GetParam();
+    auto paths = make_paths();
+    store::Store store(compact);
+    for (const auto& path : paths)
+    {
+        store.push_back(path);
+    }
+    store.finalize();
+
+    std::vector<uint32_t> visited_ids;
+    std::vector<std::string> visited;
+    store.for_each(io.ids, [&](uint32_t id, std::string_view path) {
+        visited_ids.push_back(id);
+        visited.emplace_back(path);
+    });
+
+    EXPECT_EQ(visited_ids, io.ids);
+    ASSERT_EQ(visited.size(), io.ids.size());
+    for (size_t index = 0; index < io.ids.size(); index++)
+    {
+        EXPECT_EQ(visited[index], paths[io.ids[index]]) << "Id: " << io.ids[index];
+    }
+}
+
+/**
+ * Sorted ids, sparse ones skip whole blocks
+ */
+INSTANTIATE_TEST_SUITE_P(SweepIds,
+                         TestStoreIds,
+                         testing::Combine(testing::Bool(),
+                                          testing::Values(IdsIO{.ids{}},
+                                                          IdsIO{.ids{0}},
+                                                          IdsIO{.ids{0, 1, 8}},
+                                                          IdsIO{.ids{6, 7}},
+                                                          IdsIO{.ids{BLOCK - 1, BLOCK}},
+                                                          IdsIO{.ids{BLOCK, BLOCK + 1, 2 * BLOCK + 3}},
+                                                          IdsIO{.ids{3, 4 * BLOCK + 2, 4 * BLOCK + 3, 5 * BLOCK - 1}},
+                                                          IdsIO{.ids{2 * BLOCK, 2 * BLOCK, 2 * BLOCK + 1}},
+                                                          IdsIO{.ids{1, 5 * BLOCK + 1}},
+                                                          IdsIO{.ids{5 * BLOCK}})));
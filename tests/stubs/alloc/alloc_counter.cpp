@@ -0,0 +1,107 @@
+#include "alloc_counter.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<bool> count_all{false};     /// NOLINT
+thread_local bool count_calling{false}; /// NOLINT
+std::atomic<size_t> allocations{0};     /// NOLINT
+
+void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+{
+    if (count_all || count_calling)
+    {
+        allocations++;
+    }
+    size = size == 0 ? 1 : size;
+    void* ptr = alignment > alignof(std::max_align_t) ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment) : std::malloc(size); /// NOLINT
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+} // namespace
+
+namespace stubAlloc
+{
+void start_counting(Threads threads)
+{
+    allocations = 0;
+    count_calling = true;
+    count_all = threads == Threads::ALL;
+}
+
+size_t stop_counting()
+{
+    count_all = false;
+    count_calling = false;
+    return allocations;
+}
+} // namespace stubAlloc
+
+/**
+ * Global allocation functions counting heap allocations between start_counting and stop_counting
+ */
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr); /// NOLINT
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr); /// NOLINT
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr); /// NOLINT
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr); /// NOLINT
+}
+
+void operator delete(void* ptr, std::align_val_t /*alignment*/) noexcept
+{
+    std::free(ptr); /// NOLINT
+}
+
+void operator delete[](void* ptr, std::align_val_t /*alignment*/) noexcept
+{
+    std::free(ptr); /// NOLINT
+}
+
+void operator delete(void* ptr, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+    std::free(ptr); /// NOLINT
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+    std::free(ptr); /// NOLINT
+}
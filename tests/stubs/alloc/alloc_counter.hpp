@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace stubAlloc
+{
+/**
+ * Threads whose heap allocations are counted
+ */
+enum class Threads
+{
+    CALLING, // Only the thread that started counting
+    ALL,     // Every thread, including background threads of the tested code
+};
+
+/**
+ * Resets the count and counts heap allocations from now on
+ * @param threads threads whose allocations are counted
+ */
+void start_counting(Threads threads);
+
+/**
+ * Stops counting heap allocations
+ * @return size_t heap allocations since start_counting
+ */
+size_t stop_counting();
+} // namespace stubAlloc
@@ -4,10 +4,11 @@ module;
 #include <cstddef>
 #include <curses.h>
 #include <memory>
-#include <set>
 #include <string>
+#include <vector>
 
 export module stubTui;
+import tui;
 
 namespace stubTui
 {
@@ -15,7 +16,8 @@ class MockTui
 {
   public:
     MOCK_METHOD(void, draw_input, (const std::string& input), ());
-    MOCK_METHOD(void, draw_matches, (size_t, const std::set<std::string>&, size_t), ());
+    MOCK_METHOD(void, draw_matches, (size_t, const std::vector<tui::Row>&, size_t, size_t), ());
+    MOCK_METHOD(size_t, rows, (), (const));
     MOCK_METHOD(int, get_input, (), (const));
 };
 static std::unique_ptr<MockTui> mock_up; /// NOLINT
@@ -30,9 +32,14 @@ export class MockImpl
         mock_up->draw_input(input);
     }
 
-    void static draw_matches(size_t index, const std::set<std::string>& matches, size_t total_folders)
+    void static draw_matches(size_t index, const std::vector<tui::Row>& rows, size_t matches, size_t total_folders)
     {
-        mock_up->draw_matches(index, matches, total_folders);
+        mock_up->draw_matches(index, rows, matches, total_folders);
+    }
+
+    [[nodiscard]] size_t static rows()
+    {
+        return mock_up->rows();
     }
 
     [[nodiscard]] int static get_input()
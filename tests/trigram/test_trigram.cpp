@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+import trigram;
+
+namespace
+{
+/**
+ * Ids are spread this far apart so that deltas and first ids take up to five varint bytes
+ */
+constexpr uint32_t STRIDE{1'000'003};
+
+/**
+ * Generated paths, the index holds path i under id i * STRIDE
+ */
+constexpr size_t PATHS{4000};
+
+/**
+ * Generates paths over a small alphabet so that trigrams are shared by many paths
+ */
+std::vector<std::string> generate_paths()
+{
+    constexpr uint64_t MULTIPLIER{6364136223846793005ULL};
+    constexpr uint64_t INCREMENT{1442695040888963407ULL};
+    constexpr std::string_view ALPHABET{"abcdefgh/"};
+    constexpr size_t MIN_LENGTH{1};
+    constexpr size_t MAX_LENGTH{120};
+    uint64_t state{1};
+    auto random = [&](size_t bound) {
+        state = state * MULTIPLIER + INCREMENT;
+        return static_cast<size_t>(state >> 33U) % bound;
+    };
+    std::vector<std::string> paths(PATHS);
+    for (auto& path : paths)
+    {
+        auto length = MIN_LENGTH + random(MAX_LENGTH - MIN_LENGTH + 1);
+        while (path.size() < length)
+        {
+            path.push_back(ALPHABET[random(ALPHABET.size())]);
+        }
+    }
+    return paths;
+}
+} // namespace
+
+/**
+ * Testclass comparing index queries with a scan over all paths
+ */
+class TestTrigram : public testing::Test
+{
+  protected:
+    static void SetUpTestSuite()
+    {
+        paths = generate_paths();
+        index = trigram::Index();
+        for (uint32_t path = 0; path < PATHS; path++)
+        {
+            index.add(path * STRIDE, paths[path]);
+        }
+        index.finalize();
+    }
+
+    /**
+     * @return std::vector<uint32_t> sorted ids of the paths containing every trigram of literal
+     */
+    static std::vector<uint32_t> scan_trigrams(std::string_view literal)
+    {
+        std::vector<uint32_t> ids;
+        for (uint32_t path = 0; path < PATHS; path++)
+        {
+            bool contained{true};
+            for (size_t pos = 0; contained && pos + trigram::MIN_QUERY <= literal.size(); pos++)
+            {
+                contained = paths[path].find(literal.substr(pos, trigram::MIN_QUERY)) != std::string::npos;
+            }
+            if (contained)
+            {
+                ids.push_back(path * STRIDE);
+            }
+        }
+        return ids;
+    }
+
+    /**
+     * @return std::vector<uint32_t> sorted ids of the paths containing literal
+     */
+    static std::vector<uint32_t> scan(std::string_view literal)
+    {
+        std::vector<uint32_t> ids;
+        for (uint32_t path = 0; path < PATHS; path++)
+        {
+            if (paths[path].find(literal) != std::string::npos)
+            {
+                ids.push_back(path * STRIDE);
+            }
+        }
+        return ids;
+    }
+
+    static inline std::vector<std::string> paths; /// NOLINT
+    static inline trigram::Index index;           /// NOLINT
+};
+
+/**
+ * Short literals select exactly the paths containing all of their trigrams
+ */
+TEST_F(TestTrigram, testShortLiteralsMatchScan)
+{
+    std::vector<uint32_t> ids;
+    for (std::string_view literal : {"abc", "a/b", "hhh", "//a", "bcde", "a/b/c", "gahc/e", "abcdefgh"})
+    {
+        index.query(literal, ids);
+
+        EXPECT_TRUE(std::ranges::is_sorted(ids)) << literal;
+        EXPECT_EQ(ids, scan_trigrams(literal)) << literal;
+        EXPECT_TRUE(std::ranges::includes(ids, scan(literal))) << literal;
+    }
+}
+
+/**
+ * Trigrams that no path contains give no candidates
+ */
+TEST_F(TestTrigram, testAbsentTrigram)
+{
+    std::vector<uint32_t> ids{1, 2, 3};
+    index.query("abz", ids);
+    EXPECT_TRUE(ids.empty());
+
+    index.query("abcdefz", ids);
+    EXPECT_TRUE(ids.empty());
+}
+
+/**
+ * Literals shorter than MIN_QUERY have no trigram to look up and give no candidates
+ */
+TEST_F(TestTrigram, testLiteralsBelowMinQuery)
+{
+    std::vector<uint32_t> ids{1, 2, 3};
+    for (std::string_view literal : {"", "a", "ab"})
+    {
+        index.query(literal, ids);
+        EXPECT_TRUE(ids.empty()) << literal;
+    }
+}
+
+/**
+ * Slices of indexed paths, up to whole paths with more distinct trigrams than are
+ * intersected, always give a superset of the paths containing them
+ */
+TEST_F(TestTrigram, testSlicesAreCandidates)
+{
+    constexpr size_t STEP{97};
+    std::vector<uint32_t> ids;
+    for (size_t path = 0; path < PATHS; path += STEP)
+    {
+        const auto& text = paths[path];
+        for (size_t length : {size_t{3}, size_t{8}, size_t{30}, text.size()})
+        {
+            if (length < trigram::MIN_QUERY || length > text.size())
+            {
+                continue;
+            }
+            auto literal = std::string_view(text).substr(text.size() - length);
+            index.query(literal, ids);
+
+            auto containing = scan(literal);
+            EXPECT_TRUE(std::ranges::is_sorted(ids)) << literal;
+            EXPECT_TRUE(std::ranges::binary_search(ids, static_cast<uint32_t>(path) * STRIDE)) << literal;
+            EXPECT_TRUE(std::ranges::includes(ids, containing)) << literal;
+            EXPECT_TRUE(std::ranges::includes(scan_trigrams(literal), ids)) << literal;
+        }
+    }
+}
+
+/**
+ * Ids above 2^28 take five varint bytes and must decode unchanged
+ */
+TEST(TestTrigramIds, testLargeIds)
+{
+    constexpr uint32_t LARGE{(uint32_t{1} << 28U) + 5};
+    constexpr uint32_t LARGEST{UINT32_MAX};
+    trigram::Index index;
+    index.add(0, "abcd");
+    index.add(127, "abc");
+    index.add(128, "xbcd");
+    index.add(LARGE, "bcd");
+    index.add(LARGEST, "abcd");
+    index.finalize();
+
+    std::vector<uint32_t> ids;
+    index.query("abc", ids);
+    EXPECT_EQ(ids, (std::vector<uint32_t>{0, 127, LARGEST}));
+
+    index.query("bcd", ids);
+    EXPECT_EQ(ids, (std::vector<uint32_t>{0, 128, LARGE, LARGEST}));
+
+    index.query("abcd", ids);
+    EXPECT_EQ(ids, (std::vector<uint32_t>{0, LARGEST}));
+}
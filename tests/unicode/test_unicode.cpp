@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+import unicode;
+
+/**
+ * Struct representing IO for normalize
+ */
+struct NormalizeIO
+{
+    std::string_view text;
+    bool fold{false};
+    std::string_view output;
+    std::vector<uint32_t> offsets;
+};
+
+/**
+ * Testclass for testing normalize
+ */
+class TestNormalize : public testing::TestWithParam<NormalizeIO>
+{
+};
+
+/**
+ * Parameterized test checking the normalized form and the offset of every byte in text
+ */
+TEST_P(TestNormalize, testNormalize)
+{
+    auto [text, fold, output, offsets] = GetParam();
+    std::string out;
+    std::vector<uint32_t> out_offsets;
+
+    unicode::normalize(text, fold, out, &out_offsets);
+
+    EXPECT_EQ(out, output) << "Text: " << text;
+    EXPECT_EQ(out_offsets, offsets) << "Text: " << text;
+}
+
+/**
+ * Text, case folding and the expected normalized form with its offsets
+ */
+INSTANTIATE_TEST_SUITE_P(SweepNormalize,
+                         TestNormalize,
+                         testing::Values(
+                             // Unchanged
+                             NormalizeIO{.text = "", .fold = false, .output = "", .offsets{0}},
+                             NormalizeIO{.text = "src/Core", .fold = false, .output = "src/Core", .offsets{0, 1, 2, 3, 4, 5, 6, 7, 8}},
+                             NormalizeIO{.text = "caf\xC3\xA9", .fold = false, .output = "caf\xC3\xA9", .offsets{0, 1, 2, 3, 3, 5}},
+                             // Composition of a base and a following combining mark
+                             NormalizeIO{.text = "cafe\xCC\x81", .fold = false, .output = "caf\xC3\xA9", .offsets{0, 1, 2, 3, 3, 6}},
+                             NormalizeIO{.text = "e\xCC\x81/x", .fold = false, .output = "\xC3\xA9/x", .offsets{0, 0, 3, 4, 5}},
+                             NormalizeIO{.text = "A\xCC\x8A", .fold = false, .output = "\xC3\x85", .offsets{0, 0, 3}},
+                             NormalizeIO{.text = "n\xCC\x83o", .fold = false, .output = "\xC3\xB1o", .offsets{0, 0, 3, 4}},
+                             // Marks without a base that composes with them are kept
+                             NormalizeIO{.text = "\xCC\x81" "a", .fold = false, .output = "\xCC\x81" "a", .offsets{0, 0, 2, 3}},
+                             NormalizeIO{.text = "x\xCC\x81", .fold = false, .output = "x\xCC\x81", .offsets{0, 1, 1, 3}},
+                             // Case folding, also before composing
+                             NormalizeIO{.text = "SRC/Core", .fold = true, .output = "src/core", .offsets{0, 1, 2, 3, 4, 5, 6, 7, 8}},
+                             NormalizeIO{.text = "\xC3\x89" "A", .fold = true, .output = "\xC3\xA9" "a", .offsets{0, 0, 2, 3}},
+                             NormalizeIO{.text = "E\xCC\x81", .fold = true, .output = "\xC3\xA9", .offsets{0, 0, 3}},
+                             NormalizeIO{.text = "\xCE\xA3\xCE\x91", .fold = true, .output = "\xCF\x83\xCE\xB1", .offsets{0, 0, 2, 2, 4}},
+                             NormalizeIO{.text = "\xD0\x9F\xD0\x96", .fold = true, .output = "\xD0\xBF\xD0\xB6", .offsets{0, 0, 2, 2, 4}},
+                             NormalizeIO{.text = "\xC3\x89", .fold = false, .output = "\xC3\x89", .offsets{0, 0, 2}},
+                             // Bytes that are not valid UTF-8 are kept
+                             NormalizeIO{.text = "\xFF" "a", .fold = true, .output = "\xFF" "a", .offsets{0, 1, 2}},
+                             NormalizeIO{.text = "a\xC3", .fold = true, .output = "a\xC3", .offsets{0, 1, 2}},
+                             NormalizeIO{.text = "\xC0\xAF", .fold = false, .output = "\xC0\xAF", .offsets{0, 1, 2}},
+                             NormalizeIO{.text = "\xC3" "A", .fold = true, .output = "\xC3" "a", .offsets{0, 1, 2}}));
+
+/**
+ * Normalized forms of equivalent names compare equal
+ */
+TEST(TestUnicode, testEquivalentForms)
+{
+    std::string composed;
+    std::string decomposed;
+    unicode::normalize("R\xC3\xA9sum\xC3\xA9", true, composed);
+    unicode::normalize("RE\xCC\x81SUME\xCC\x81", true, decomposed);
+
+    EXPECT_EQ(composed, decomposed);
+}
+
+/**
+ * Sequence lengths and continuation bytes of UTF-8 leads
+ */
+TEST(TestUnicode, testLength)
+{
+    EXPECT_EQ(unicode::length('a'), 1);
+    EXPECT_EQ(unicode::length('\xC3'), 2);
+    EXPECT_EQ(unicode::length('\xE2'), 3);
+    EXPECT_EQ(unicode::length('\xF0'), 4);
+    EXPECT_EQ(unicode::length('\x80'), 1);
+    EXPECT_EQ(unicode::length('\xFF'), 1);
+
+    EXPECT_TRUE(unicode::continuation('\x80'));
+    EXPECT_TRUE(unicode::continuation('\xBF'));
+    EXPECT_FALSE(unicode::continuation('a'));
+    EXPECT_FALSE(unicode::continuation('\xC3'));
+}
+
+/**
+ * Typed text is complete once its last character has all its bytes
+ */
+TEST(TestUnicode, testComplete)
+{
+    EXPECT_TRUE(unicode::complete(""));
+    EXPECT_TRUE(unicode::complete("ab"));
+    EXPECT_FALSE(unicode::complete("a\xC3"));
+    EXPECT_TRUE(unicode::complete("a\xC3\xA9"));
+    EXPECT_FALSE(unicode::complete("\xE2\x82"));
+    EXPECT_TRUE(unicode::complete("\xE2\x82\xAC"));
+    EXPECT_FALSE(unicode::complete("\xF0\x9F\x98"));
+    EXPECT_TRUE(unicode::complete("\xF0\x9F\x98\x80"));
+}
+
+/**
+ * The ASCII fast path only accepts text normalize leaves unchanged
+ */
+TEST(TestUnicode, testPlain)
+{
+    EXPECT_TRUE(unicode::plain("src/core", false));
+    EXPECT_TRUE(unicode::plain("src/Core", false));
+    EXPECT_FALSE(unicode::plain("src/Core", true));
+    EXPECT_TRUE(unicode::plain("src/core", true));
+    EXPECT_FALSE(unicode::plain("caf\xC3\xA9", false));
+}
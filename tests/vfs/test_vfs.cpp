@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+#include <cstddef>
+#include <functional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+import vfs;
+
+/**
+ * Testclass listing generated trees of different shapes
+ */
+class TestSynthetic : public testing::TestWithParam<vfs::Shape>
+{
+};
+
+/**
+ * Every directory lists uniquely named subdirectories within the name bounds, together with its files
+ */
+TEST_P(TestSynthetic, testSiblingsAreUnique)
+{
+    auto shape = GetParam();
+    vfs::Synthetic filesystem(shape);
+
+    size_t listed{0};
+    std::function<void(vfs::Synthetic::Handle, size_t)> list = [&](vfs::Synthetic::Handle directory, size_t depth) {
+        std::set<std::string> names;
+        std::vector<vfs::Synthetic::Handle> children;
+        auto entries = filesystem.list(directory, "synthetic", [&](std::string_view name, bool symlink, vfs::Synthetic::Handle handle) {
+            EXPECT_FALSE(symlink);
+            EXPECT_GE(name.size(), shape.min_name);
+            EXPECT_TRUE(names.emplace(name).second) << "Sibling name " << name << " repeats at depth " << depth;
+            children.push_back(handle);
+        });
+        EXPECT_EQ(entries, names.size() + shape.files);
+        if (depth == shape.depth)
+        {
+            EXPECT_TRUE(names.empty());
+        }
+        else
+        {
+            EXPECT_GE(names.size(), shape.min_fanout);
+            EXPECT_LE(names.size(), shape.max_fanout);
+        }
+        listed += names.size();
+        for (auto child : children)
+        {
+            list(child, depth + 1);
+        }
+    };
+    list(filesystem.open("synthetic"), 0);
+
+    EXPECT_EQ(listed, filesystem.size());
+}
+
+/**
+ * Narrow and deep trees, then fanouts around the 26 and 676 siblings a one or two letter prefix can tell apart
+ */
+INSTANTIATE_TEST_SUITE_P(SweepShapes,
+                         TestSynthetic,
+                         testing::Values(vfs::Shape{.min_fanout = 1, .max_fanout = 3, .depth = 6, .min_name = 1, .max_name = 4, .files = 2},
+                                         vfs::Shape{.min_fanout = 26, .max_fanout = 27, .depth = 2, .min_name = 1, .max_name = 1},
+                                         vfs::Shape{.min_fanout = 676, .max_fanout = 677, .depth = 1, .min_name = 1, .max_name = 2},
+                                         vfs::Shape{.min_fanout = 700, .max_fanout = 700, .depth = 2, .min_name = 1, .max_name = 1, .files = 5}));
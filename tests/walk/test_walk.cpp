@@ -0,0 +1,245 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+import vfs;
+import walk;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+/**
+ * Folder as reported by the walker
+ */
+struct Found
+{
+    std::string path;
+    size_t depth{0};
+    uint32_t parent{walk::ROOT};
+};
+
+/**
+ * Walk of a whole tree
+ */
+struct Walk
+{
+    std::vector<Found> found;
+    std::vector<uint32_t> read;
+};
+
+/**
+ * Walks filesystem to the end
+ * @param budget folders a top level subtree may yield per round
+ */
+template <typename FS>
+Walk walk_all(const FS& filesystem, size_t budget)
+{
+    Walk walk;
+    walk::Walker walker(filesystem, "root", budget, true);
+    auto found = [&](std::string_view path, size_t depth, uint32_t parent) { walk.found.push_back({.path = std::string(path), .depth = depth, .parent = parent}); };
+    auto read = [&](uint32_t id, const walk::Metadata& /*metadata*/) { walk.read.push_back(id); };
+    while (walker.step(found, read))
+    {
+    }
+    return walk;
+}
+
+/**
+ * Lists the path of every folder of filesystem relative to its root
+ */
+std::vector<std::string> list_paths(const vfs::Synthetic& filesystem)
+{
+    std::vector<std::string> paths;
+    std::function<void(vfs::Synthetic::Handle, const std::string&)> list = [&](vfs::Synthetic::Handle directory, const std::string& prefix) {
+        filesystem.list(directory, "root", [&](std::string_view name, bool /*symlink*/, vfs::Synthetic::Handle handle) {
+            paths.push_back(prefix + std::string(name));
+            list(handle, paths.back() + "/");
+        });
+    };
+    list(filesystem.open("root"), "");
+    return paths;
+}
+
+/**
+ * Top level folder of path
+ */
+std::string_view top(std::string_view path)
+{
+    return path.substr(0, path.find('/'));
+}
+
+/**
+ * Filesystem backend with one large subtree listed before several small ones
+ */
+class Skewed
+{
+  public:
+    using Handle = uint32_t;
+
+    static constexpr size_t BIG_FANOUT{4};
+    static constexpr size_t BIG_DEPTH{5};
+    static constexpr size_t SMALL{5};
+    static constexpr size_t SMALL_FANOUT{2};
+    static constexpr size_t SMALL_DEPTH{3};
+
+    Skewed()
+    {
+        m_nodes.push_back({});
+        add(0, "big", BIG_FANOUT, BIG_DEPTH - 1);
+        for (size_t small = 0; small < SMALL; small++)
+        {
+            add(0, "s" + std::to_string(small), SMALL_FANOUT, SMALL_DEPTH - 1);
+        }
+        // Reported, but never read
+        add(0, "link", SMALL_FANOUT, SMALL_DEPTH - 1, true);
+    }
+
+    [[nodiscard]] static Handle open(const fs::path& /*root*/)
+    {
+        return 0;
+    }
+
+    size_t list(const Handle& directory, const fs::path& /*path*/, auto&& func) const
+    {
+        for (auto child : m_nodes[directory].children)
+        {
+            func(std::string_view(m_nodes[child].name), m_nodes[child].symlink, child);
+        }
+        return m_nodes[directory].children.size();
+    }
+
+    [[nodiscard]] static vfs::Stat stat(const Handle& /*directory*/, const fs::path& /*path*/)
+    {
+        return {};
+    }
+
+  private:
+    struct Node
+    {
+        std::string name;
+        bool symlink{false};
+        std::vector<uint32_t> children;
+    };
+
+    void add(uint32_t parent, std::string name, size_t fanout, size_t levels, bool symlink = false)
+    {
+        auto node = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back({.name = std::move(name), .symlink = symlink, .children = {}});
+        m_nodes[parent].children.push_back(node);
+        for (size_t child = 0; levels != 0 && child < fanout; child++)
+        {
+            add(node, std::string(1, static_cast<char>('a' + child)), fanout, levels - 1);
+        }
+    }
+
+    std::vector<Node> m_nodes;
+};
+} // namespace
+
+/**
+ * Testclass walking a generated tree with different budgets
+ */
+class TestWalk : public testing::TestWithParam<size_t>
+{
+};
+
+/**
+ * Every folder is found once below its parent and every directory is read once,
+ * within a top level subtree shallow folders are found before deeper ones
+ */
+TEST_P(TestWalk, testFindsEveryFolder)
+{
+    constexpr size_t FANOUT{4};
+    constexpr size_t DEPTH{5};
+    vfs::Synthetic filesystem({.min_fanout = FANOUT, .max_fanout = FANOUT, .depth = DEPTH});
+    auto budget = GetParam();
+
+    auto walk = walk_all(filesystem, budget);
+
+    std::vector<std::string> paths;
+    for (const auto& found : walk.found)
+    {
+        paths.push_back(found.path);
+        EXPECT_EQ(found.depth, static_cast<size_t>(std::ranges::count(found.path, '/')) + 1) << found.path;
+        if (found.parent == walk::ROOT)
+        {
+            EXPECT_EQ(found.depth, 1) << found.path;
+            continue;
+        }
+        ASSERT_LT(found.parent, walk.found.size());
+        EXPECT_EQ(walk.found[found.parent].path + "/", found.path.substr(0, found.path.rfind('/') + 1));
+    }
+    auto expected = list_paths(filesystem);
+    std::ranges::sort(paths);
+    std::ranges::sort(expected);
+    EXPECT_EQ(paths, expected);
+
+    std::ranges::sort(walk.read);
+    ASSERT_EQ(walk.read.size(), walk.found.size());
+    for (uint32_t id = 0; id < walk.read.size(); id++)
+    {
+        EXPECT_EQ(walk.read[id], id);
+    }
+
+    for (size_t found = 1; found < walk.found.size(); found++)
+    {
+        if (budget == 0)
+        {
+            EXPECT_LE(walk.found[found - 1].depth, walk.found[found].depth) << walk.found[found].path;
+        }
+        for (auto earlier = found; earlier-- > 0;)
+        {
+            if (top(walk.found[earlier].path) == top(walk.found[found].path))
+            {
+                EXPECT_LE(walk.found[earlier].depth, walk.found[found].depth) << walk.found[found].path;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * No budget for a plain breadth-first walk, then budgets below and above the subtree sizes
+ */
+INSTANTIATE_TEST_SUITE_P(SweepBudgets, TestWalk, testing::Values(0, 1, 7, 100, 100000));
+
+/**
+ * A subtree over its budget is deferred behind the small subtrees and still walked in full
+ */
+TEST(TestWalkBudget, testDefersLargeSubtree)
+{
+    constexpr size_t BUDGET{8};
+    Skewed filesystem;
+    auto count_big_before_small = [](const Walk& walk) {
+        auto last_small = std::ranges::find_if(walk.found.rbegin(), walk.found.rend(), [](const Found& found) { return found.path.starts_with('s'); });
+        return static_cast<size_t>(std::count_if(walk.found.begin(), last_small.base(), [](const Found& found) { return top(found.path) == "big"; }));
+    };
+
+    auto breadth_first = walk_all(filesystem, 0);
+    auto budgeted = walk_all(filesystem, BUDGET);
+
+    // Breadth first reaches the third level of the large subtree before the small subtrees end
+    EXPECT_GT(count_big_before_small(breadth_first), BUDGET + Skewed::BIG_FANOUT);
+    // A subtree overshoots its budget by at most one listing before it is deferred
+    EXPECT_LE(count_big_before_small(budgeted), BUDGET + Skewed::BIG_FANOUT);
+
+    size_t big{0};
+    for (size_t level = 1, width = 1; level <= Skewed::BIG_DEPTH; level++, width *= Skewed::BIG_FANOUT)
+    {
+        big += width;
+    }
+    EXPECT_EQ(std::ranges::count_if(budgeted.found, [](const Found& found) { return top(found.path) == "big"; }), big);
+    EXPECT_EQ(budgeted.found.size(), breadth_first.found.size());
+
+    // Symlinked folders are reported but not followed
+    EXPECT_EQ(std::ranges::count_if(budgeted.found, [](const Found& found) { return found.path.starts_with("link"); }), 1);
+    auto link = std::ranges::find(budgeted.found, "link", &Found::path) - budgeted.found.begin();
+    EXPECT_EQ(std::ranges::count(budgeted.read, static_cast<uint32_t>(link)), 0);
+}